@@ -1,6 +1,15 @@
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <string>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 /*
 
@@ -17,6 +26,25 @@ This makes Bubble Sort inefficient for large datasets.
    - Bubble Sort is an in-place sorting algorithm, meaning it doesn't require additional memory for sorting and operates directly on the input array.
    - The space complexity is O(1), which indicates constant space usage. The amount of extra memory used by the algorithm does not depend on the size of the input array.
 
+Data-parallel variants:
+Bubble Sort is strictly sequential because every swap may feed the next comparison. The two variants below are still in-place, but only use
+compare-exchange steps on disjoint pairs, so every step of a phase can run at the same time on different threads and SIMD lanes.
+A compare-exchange writes min(a, b) and max(a, b) back without branching, and the sequence of memory accesses does not depend on the data.
+
+1. Odd-Even Transposition Sort:
+   - Phase p compares the pairs (0,1), (2,3), ... when p is even and (1,2), (3,4), ... when p is odd. After n phases the array is sorted.
+   - The pairs of a phase are split between the threads, with a barrier between phases. Within a thread, two adjacent pairs are
+     compare-exchanged at once with SSE2 min/max.
+   - Time complexity: O(n^2) work in n phases, O(n^2 / p) time on p threads.
+   - Space complexity: O(1).
+
+2. Batcher's Odd-Even Merge Sort:
+   - A sorting network: a fixed sequence of O(log^2 n) stages, each made of disjoint compare-exchanges. Sizes that are not a power of two
+     use the network of the next power of two and drop the comparators that reach past the end.
+   - The comparators of a stage are split between the threads, with a barrier between stages.
+   - Time complexity: O(n log^2 n) work in O(log^2 n) stages.
+   - Space complexity: O(1).
+
 */
 
 void swap(int &a, int &b) {
@@ -25,9 +53,9 @@ void swap(int &a, int &b) {
     b = temp;
 }
 
-void bubbleSort(int arr[], int n) {
-    for (int i_itr = 0; i_itr < n - 1; i_itr++) {
-        for (int j_itr = 0; j_itr < n - i_itr - 1; j_itr++) {
+void bubbleSort(int arr[], size_t n) {
+    for (size_t i_itr = 0; i_itr + 1 < n; i_itr++) {
+        for (size_t j_itr = 0; j_itr + i_itr + 1 < n; j_itr++) {
             if (arr[j_itr] > arr[j_itr + 1]) {
                 swap(arr[j_itr], arr[j_itr + 1]);
             }
@@ -35,14 +63,182 @@ void bubbleSort(int arr[], int n) {
     }
 }
 
-void printArray(int arr[], int size) {
-    for (int i_itr = 0; i_itr < size; i_itr++) {
+// Branch-free compare-exchange, the smaller value ends up at index i
+inline void compareExchange(int arr[], size_t i, size_t j) {
+    int a = arr[i];
+    int b = arr[j];
+    arr[i] = std::min(a, b);
+    arr[j] = std::max(a, b);
+}
+
+// Compare-exchange the adjacent pairs (first, first + 1), (first + 2, first + 3), ... for numPairs pairs
+void compareExchangePairs(int arr[], size_t first, size_t numPairs) {
+    size_t pair = 0;
+#ifdef __SSE2__
+    // Two pairs per vector: [a0 b0 a1 b1] against [b0 a0 b1 a1], keep the minimum in the even lanes and the maximum in the odd lanes
+    const __m128i oddLanes = _mm_set_epi32(-1, 0, -1, 0);
+    for (; pair + 2 <= numPairs; pair += 2) {
+        __m128i* address = reinterpret_cast<__m128i*>(arr + first + 2 * pair);
+        __m128i values = _mm_loadu_si128(address);
+        __m128i swapped = _mm_shuffle_epi32(values, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128i greater = _mm_cmpgt_epi32(values, swapped);
+        __m128i minimum = _mm_or_si128(_mm_and_si128(greater, swapped), _mm_andnot_si128(greater, values));
+        __m128i maximum = _mm_or_si128(_mm_and_si128(greater, values), _mm_andnot_si128(greater, swapped));
+        __m128i result = _mm_or_si128(_mm_and_si128(oddLanes, maximum), _mm_andnot_si128(oddLanes, minimum));
+        _mm_storeu_si128(address, result);
+    }
+#endif
+    for (; pair < numPairs; pair++) {
+        compareExchange(arr, first + 2 * pair, first + 2 * pair + 1);
+    }
+}
+
+// Reusable barrier for the worker threads of one sort
+class SpinBarrier {
+public:
+    explicit SpinBarrier(int numThreads) : numThreads(numThreads), waiting(0), generation(0) {}
+
+    void wait() {
+        int currentGeneration = generation.load(std::memory_order_acquire);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) == numThreads - 1) {
+            waiting.store(0, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_acq_rel);
+            return;
+        }
+        while (generation.load(std::memory_order_acquire) == currentGeneration) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    const int numThreads;
+    std::atomic<int> waiting;
+    std::atomic<int> generation;
+};
+
+// Run work(phase, thread, numThreads) for every phase on numThreads threads, all threads finish a phase before the next one starts
+template <typename Work>
+void runPhases(int numThreads, size_t numPhases, Work work) {
+    if (numThreads <= 1) {
+        for (size_t phase = 0; phase < numPhases; phase++) {
+            work(phase, 0, 1);
+        }
+        return;
+    }
+
+    SpinBarrier barrier(numThreads);
+    auto worker = [&](int thread) {
+        for (size_t phase = 0; phase < numPhases; phase++) {
+            work(phase, thread, numThreads);
+            barrier.wait();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int thread = 1; thread < numThreads; thread++) {
+        threads.emplace_back(worker, thread);
+    }
+    worker(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// Below this many elements per thread the barriers cost more than the extra threads save
+const size_t MIN_ELEMENTS_PER_THREAD = 8192;
+
+int chooseThreads(size_t n) {
+    size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    return static_cast<int>(std::max<size_t>(1, std::min(hardwareThreads, n / MIN_ELEMENTS_PER_THREAD)));
+}
+
+void oddEvenTranspositionSort(int arr[], size_t n) {
+    runPhases(chooseThreads(n), n, [arr, n](size_t phase, int thread, int numThreads) {
+        // Pairs of this phase start at 0 or 1, every thread takes a contiguous share of them
+        size_t first = phase % 2;
+        size_t numPairs = n > first ? (n - first) / 2 : 0;
+        size_t begin = numPairs / numThreads * thread + std::min<size_t>(thread, numPairs % numThreads);
+        size_t end = numPairs / numThreads * (thread + 1) + std::min<size_t>(thread + 1, numPairs % numThreads);
+        compareExchangePairs(arr, first + 2 * begin, end - begin);
+    });
+}
+
+void oddEvenMergeSort(int arr[], size_t n) {
+    // List the stages of the network, each stage is a (p, k) pair
+    std::vector<std::pair<size_t, size_t>> stages;
+    for (size_t p = 1; p < n; p <<= 1) {
+        for (size_t k = p; k >= 1; k >>= 1) {
+            stages.push_back({p, k});
+        }
+    }
+
+    runPhases(chooseThreads(n), stages.size(), [arr, n, &stages](size_t stage, int thread, int numThreads) {
+        size_t p = stages[stage].first;
+        size_t k = stages[stage].second;
+
+        // The blocks starting at j are independent, every thread takes every numThreads-th block
+        size_t blockIndex = 0;
+        for (size_t j = k % p; j + k < n; j += 2 * k, blockIndex++) {
+            if (blockIndex % numThreads != static_cast<size_t>(thread)) {
+                continue;
+            }
+            size_t count = std::min(k, n - j - k);
+            for (size_t i = 0; i < count; i++) {
+                // Only compare elements that belong to the same merge of two sorted runs of length p
+                if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                    compareExchange(arr, i + j, i + j + k);
+                }
+            }
+        }
+    });
+}
+
+void printArray(int arr[], size_t size) {
+    for (size_t i_itr = 0; i_itr < size; i_itr++) {
         std::cout << arr[i_itr] << " ";
     }
     std::cout << std::endl;
 }
 
-int main() {
+// Returns false when a variant does not match std::sort
+bool runBenchmarks() {
+    const size_t n = 1 << 15;
+    std::mt19937 generator(42);
+    std::vector<int> data(n);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        data[i_itr] = static_cast<int>(generator());
+    }
+
+    std::vector<int> reference = data;
+    std::sort(reference.begin(), reference.end());
+
+    const char* names[] = {"Bubble sort", "Odd-even transposition sort", "Odd-even merge sort"};
+    void (*sorts[])(int[], size_t) = {bubbleSort, oddEvenTranspositionSort, oddEvenMergeSort};
+
+    std::cout << n << " elements, up to " << chooseThreads(n) << " threads" << std::endl;
+    bool allMatch = true;
+    for (int i_itr = 0; i_itr < 3; i_itr++) {
+        std::vector<int> arr = data;
+        auto start = std::chrono::high_resolution_clock::now();
+        sorts[i_itr](arr.data(), n);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+        std::cout << names[i_itr] << ": " << duration.count() << " nanoseconds"
+                  << (arr == reference ? "" : " [MISMATCH]") << std::endl;
+        allMatch = allMatch && arr == reference;
+    }
+    return allMatch;
+}
+
+int main(int argc, char* argv[]) {
+    // The benchmarks take seconds, so they only run with --benchmark
+    bool benchmark = argc == 2 && std::string(argv[1]) == "--benchmark";
+    if (argc > 1 && !benchmark) {
+        std::cerr << "Usage: " << argv[0] << " [--benchmark]" << std::endl;
+        return 1;
+    }
+
     const char* filename = "../input_sort.txt";
     std::ifstream inputFile(filename);
 
@@ -51,29 +247,35 @@ int main() {
         return 1;
     }
 
-    int n;
+    size_t n;
     inputFile >> n;
 
-    int arr[n];
-    for (int i_itr = 0; i_itr < n; i_itr++) {
+    // Heap storage, a stack array overflows for large inputs
+    std::vector<int> arr(n);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
         inputFile >> arr[i_itr];
     }
 
     inputFile.close();
 
     std::cout << "Unsorted array: ";
-    printArray(arr, n);
+    printArray(arr.data(), n);
 
     // Measure the execution time
     auto start = std::chrono::high_resolution_clock::now();
-    bubbleSort(arr, n);
+    bubbleSort(arr.data(), n);
     auto end = std::chrono::high_resolution_clock::now();
 
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
 
     std::cout << "Sorted array: ";
-    printArray(arr, n);
+    printArray(arr.data(), n);
     std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
 
+    // Compare the data-parallel variants with Bubble Sort on a larger input, a mismatch fails the run
+    if (benchmark && !runBenchmarks()) {
+        return 1;
+    }
+
     return 0;
 }
@@ -3,6 +3,11 @@
 #include <vector>
 #include <fstream>
 #include <chrono>
+#include <random>
+#include <utility>
+#include "../sort_workspace.h"
+#include <string>
+#include "../large_array_test.h"
 using namespace std;
 
 /*
@@ -30,13 +35,35 @@ Additional Details:-
 Counting Sort is particularly useful when the range of input values is not significantly larger than the number of elements. 
 It is a stable, non-comparative sorting algorithm that can be efficient for certain types of datasets, especially when dealing with integers or small key ranges.
 
+Scratch Memory:
+- The count and output arrays come from a SortWorkspace (see ../sort_workspace.h) instead of new vectors, so repeated calls reuse the same
+  memory. Without an explicit workspace the calling thread's workspace is used.
+
+Fused Grouping:
+- After sorting, the next step is usually a deduplication or a count of every value, which is one more pass over n elements.
+  The count array already holds the exact number of occurrences of every value, so these results are read from it directly:
+  - countingSortUnique returns the distinct values in sorted order.
+  - countingSortCount returns every distinct value with its number of occurrences.
+  - countingSortDedupInPlace replaces the array by its distinct values in sorted order.
+- They skip the prefix sum, the output array and the copy back: one read pass over n elements and one scan over the k counts,
+  and the result only has as many elements as there are distinct values.
+
 */
-void countingSort(std::vector<int>& arr) {
+template <typename Allocator>
+void countingSort(std::vector<int, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    if (arr.empty()) {
+        return;
+    }
+
     // Find the maximum element in the array
-    int maxElement = *max_element(arr.begin(), arr.end());
+    size_t maxElement = *max_element(arr.begin(), arr.end());
+
+    // Scratch arrays are released when the scope ends
+    WorkspaceScope scope(workspace);
 
-    // Create a count array to store the count of each element
-    std::vector<int> count(maxElement + 1, 0);
+    // Create a count array to store the count of each element, 64-bit so a value may occur more than 2^31 times
+    size_t* count = workspace.allocate<size_t>(maxElement + 1);
+    std::fill(count, count + maxElement + 1, 0);
 
     // Count the occurrences of each element in the input array
     for (int num : arr) {
@@ -44,25 +71,200 @@ void countingSort(std::vector<int>& arr) {
     }
 
     // Update the count array to store the cumulative count
-    for (int i_itr = 1; i_itr <= maxElement; i_itr++) {
+    for (size_t i_itr = 1; i_itr <= maxElement; i_itr++) {
         count[i_itr] += count[i_itr - 1];
     }
 
     // Create a temporary array to store the sorted elements
-    std::vector<int> output(arr.size());
+    int* output = workspace.allocate<int>(arr.size());
 
     // Build the output array using the count array
-    for (int i_itr = arr.size() - 1; i_itr >= 0; i_itr--) {
+    for (size_t i_itr = arr.size(); i_itr-- > 0;) {
         output[count[arr[i_itr]] - 1] = arr[i_itr];
         count[arr[i_itr]]--;
     }
 
     // Copy the sorted elements back to the original array
-    for (int i_itr = 0; i_itr < arr.size(); i_itr++) {
+    for (size_t i_itr = 0; i_itr < arr.size(); i_itr++) {
         arr[i_itr] = output[i_itr];
     }
 }
 
+// Counts the occurrences of every value and calls emit(value, occurrences) for every value present, in ascending order
+template <typename Allocator, typename Emit>
+void countingSortGroups(const std::vector<int, Allocator>& arr, SortWorkspace& workspace, Emit emit) {
+    if (arr.empty()) {
+        return;
+    }
+
+    size_t maxElement = *max_element(arr.begin(), arr.end());
+
+    WorkspaceScope scope(workspace);
+    size_t* count = workspace.allocate<size_t>(maxElement + 1);
+    std::fill(count, count + maxElement + 1, 0);
+
+    for (int num : arr) {
+        count[num]++;
+    }
+
+    for (size_t value = 0; value <= maxElement; value++) {
+        if (count[value] > 0) {
+            emit(static_cast<int>(value), count[value]);
+        }
+    }
+}
+
+// Distinct values of arr in sorted order
+template <typename Allocator>
+std::vector<int> countingSortUnique(const std::vector<int, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    std::vector<int> result;
+    countingSortGroups(arr, workspace, [&result](int value, size_t) {
+        result.push_back(value);
+    });
+    return result;
+}
+
+// Distinct values of arr in sorted order, each with its number of occurrences
+template <typename Allocator>
+std::vector<std::pair<int, size_t>> countingSortCount(const std::vector<int, Allocator>& arr,
+                                                      SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    std::vector<std::pair<int, size_t>> result;
+    countingSortGroups(arr, workspace, [&result](int value, size_t occurrences) {
+        result.emplace_back(value, occurrences);
+    });
+    return result;
+}
+
+// Sort arr and remove duplicates, arr keeps one element per distinct value
+template <typename Allocator>
+void countingSortDedupInPlace(std::vector<int, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    // The values are written after the counting pass has read all of arr
+    size_t size = 0;
+    countingSortGroups(arr, workspace, [&arr, &size](int value, size_t) {
+        arr[size++] = value;
+    });
+    arr.resize(size);
+}
+
+// Same algorithm with fresh vectors on every call, to measure what the workspace saves
+void countingSortWithVectors(std::vector<int>& arr) {
+    size_t maxElement = *max_element(arr.begin(), arr.end());
+    std::vector<size_t> count(maxElement + 1, 0);
+    for (int num : arr) {
+        count[num]++;
+    }
+    for (size_t i_itr = 1; i_itr <= maxElement; i_itr++) {
+        count[i_itr] += count[i_itr - 1];
+    }
+    std::vector<int> output(arr.size());
+    for (size_t i_itr = arr.size(); i_itr-- > 0;) {
+        output[count[arr[i_itr]] - 1] = arr[i_itr];
+        count[arr[i_itr]]--;
+    }
+    for (size_t i_itr = 0; i_itr < arr.size(); i_itr++) {
+        arr[i_itr] = output[i_itr];
+    }
+}
+
+// Sort many arrays in a row, as a service does, with and without a workspace. Returns false when the results differ
+bool runBenchmarks() {
+    const int numArrays = 2000;
+    const int arraySize = 20000;
+    const int maxValue = 1 << 16;
+
+    std::mt19937 generator(42);
+    std::vector<std::vector<int>> arrays(numArrays, std::vector<int>(arraySize));
+    for (std::vector<int>& arr : arrays) {
+        for (int& value : arr) {
+            value = generator() % maxValue;
+        }
+    }
+
+    std::vector<std::vector<int>> copies = arrays;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (std::vector<int>& arr : copies) {
+        countingSortWithVectors(arr);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    std::cout << numArrays << " arrays of " << arraySize << " elements, new vectors per call: "
+              << duration.count() << " nanoseconds" << std::endl;
+
+    std::vector<std::vector<int>> reference = copies;
+    SortWorkspace workspace;
+    copies = arrays;
+    start = std::chrono::high_resolution_clock::now();
+    for (std::vector<int>& arr : copies) {
+        countingSort(arr, workspace);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    std::cout << numArrays << " arrays of " << arraySize << " elements, SortWorkspace: "
+              << duration.count() << " nanoseconds, high-water mark " << workspace.highWaterMark()
+              << " bytes, " << workspace.mappings() << " mappings" << (copies == reference ? "" : " [MISMATCH]") << std::endl;
+    return copies == reference;
+}
+
+// Group-by workload with many repeated keys: sort followed by a second pass, against the fused operators.
+// Returns false when a fused operator does not match the two-pass result
+bool runGroupingBenchmark() {
+    const size_t n = 1 << 24;
+    const int maxValue = 1 << 16;
+
+    std::mt19937 generator(42);
+    std::vector<int> data(n);
+    for (int& value : data) {
+        value = generator() % maxValue;
+    }
+
+    // Baseline: sort, then a counting pass or std::unique over the sorted array
+    std::vector<int> sorted = data;
+    auto start = std::chrono::high_resolution_clock::now();
+    countingSort(sorted);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto sortDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<std::pair<int, size_t>> expectedCounts;
+    for (size_t i_itr = 0; i_itr < sorted.size(); i_itr++) {
+        if (expectedCounts.empty() || expectedCounts.back().first != sorted[i_itr]) {
+            expectedCounts.emplace_back(sorted[i_itr], 0);
+        }
+        expectedCounts.back().second++;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto countDuration = sortDuration + std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    end = std::chrono::high_resolution_clock::now();
+    auto uniqueDuration = sortDuration + std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<std::pair<int, size_t>> counts = countingSortCount(data);
+    end = std::chrono::high_resolution_clock::now();
+    auto fusedCountDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<int> unique = countingSortUnique(data);
+    end = std::chrono::high_resolution_clock::now();
+    auto fusedUniqueDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::vector<int> deduplicated = data;
+    start = std::chrono::high_resolution_clock::now();
+    countingSortDedupInPlace(deduplicated);
+    end = std::chrono::high_resolution_clock::now();
+    auto dedupDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << n << " elements, " << unique.size() << " distinct" << std::endl;
+    std::cout << "Sort + count pass: " << countDuration.count() << " nanoseconds, countingSortCount: "
+              << fusedCountDuration.count() << " nanoseconds" << (counts == expectedCounts ? "" : " [MISMATCH]") << std::endl;
+    std::cout << "Sort + std::unique: " << uniqueDuration.count() << " nanoseconds, countingSortUnique: "
+              << fusedUniqueDuration.count() << " nanoseconds, countingSortDedupInPlace: " << dedupDuration.count() << " nanoseconds"
+              << (unique == sorted && deduplicated == sorted ? "" : " [MISMATCH]") << std::endl;
+    return counts == expectedCounts && unique == sorted && deduplicated == sorted;
+}
+
 void printArray(const std::vector<int>& arr) {
     for (int num : arr) {
         std::cout << num << " ";
@@ -70,7 +272,19 @@ void printArray(const std::vector<int>& arr) {
     std::cout << std::endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // ./counting_sort N [--interleave] sorts N random values in huge pages, see ../large_array_test.h.
+    // The benchmarks take seconds, so they only run with --benchmark
+    bool benchmark = argc == 2 && std::string(argv[1]) == "--benchmark";
+    if (argc > 1 && !benchmark) {
+        // The scratch buffers of such a sort are as large as the input, so they use huge pages as well
+        auto generate = [](std::mt19937_64& generator) { return static_cast<int>(generator() % (1 << 20)); };
+        return runLargeTest<int>(argc, argv, generate, [](HugePageVector<int>& arr, const LargePageOptions& options) {
+            SortWorkspace workspace(options);
+            countingSort(arr, workspace);
+        });
+    }
+
     const char* filename = "../input_sort.txt";
     std::ifstream inputFile(filename);
 
@@ -104,5 +318,14 @@ int main() {
     printArray(arr);
     std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
 
+    // Compare the workspace with fresh vectors and the fused operators with two passes, a mismatch fails the run
+    if (benchmark) {
+        bool allMatch = runBenchmarks();
+        allMatch = runGroupingBenchmark() && allMatch;
+        if (!allMatch) {
+            return 1;
+        }
+    }
+
     return 0;
 }
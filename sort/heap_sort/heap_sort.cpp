@@ -2,6 +2,9 @@
 #include <vector>
 #include <fstream>
 #include <chrono>
+#include <algorithm>
+#include <random>
+#include "../large_array_test.h"
 
 /*
 
@@ -21,13 +24,19 @@ This in-place characteristic contributes to its efficient use of memory.
 2. Space Complexity:
    - Heap Sort has a space complexity of O(1) for in-place sorting. The algorithm does not require additional memory proportional to the input size, making it an in-place sorting algorithm.
 
+Large Arrays:
+   - Indices are size_t, so the child index 2 * i + 2 cannot overflow and arrays beyond 2^31 elements can be sorted.
+   - heapify jumps to a far away child on every level, which misses the TLB for large heaps. Arrays from HugePageVector (see ../huge_page_allocator.h)
+     are backed by 2 MB pages, which cover 512 times more memory per TLB entry.
+
 */
 
 
-void heapify(std::vector<int>& arr, int n, int i) {
-    int largest = i; // Initialize largest as the root
-    int left = 2 * i + 1; // Left child
-    int right = 2 * i + 2; // Right child
+template <typename Allocator>
+void heapify(std::vector<int, Allocator>& arr, size_t n, size_t i) {
+    size_t largest = i; // Initialize largest as the root
+    size_t left = 2 * i + 1; // Left child
+    size_t right = 2 * i + 2; // Right child
 
     // If the left child is larger than the root
     if (left < n && arr[left] > arr[largest]) {
@@ -48,16 +57,17 @@ void heapify(std::vector<int>& arr, int n, int i) {
     }
 }
 
-void heapSort(std::vector<int>& arr) {
-    int n = arr.size();
+template <typename Allocator>
+void heapSort(std::vector<int, Allocator>& arr) {
+    size_t n = arr.size();
 
     // Build a max heap (rearrange array)
-    for (int i_itr= n / 2 - 1; i_itr >= 0; i_itr--) {
+    for (size_t i_itr = n / 2; i_itr-- > 0;) {
         heapify(arr, n, i_itr);
     }
 
     // One by one extract elements from the heap
-    for (int i_itr = n - 1; i_itr > 0; i_itr--) {
+    for (size_t i_itr = n; i_itr-- > 1;) {
         // Move the current root to the end
         std::swap(arr[0], arr[i_itr]);
 
@@ -73,7 +83,14 @@ void printArray(const std::vector<int>& arr) {
     std::cout << std::endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // ./heap_sort N [--interleave] sorts N random values in huge pages, see ../large_array_test.h
+    if (argc > 1) {
+        return runLargeTest<int>(argc, argv, randomValue<int>, [](HugePageVector<int>& arr, const LargePageOptions&) {
+            heapSort(arr);
+        });
+    }
+
     const char* filename = "../input_sort.txt";
     std::ifstream inputFile(filename);
 
@@ -0,0 +1,175 @@
+#ifndef HUGE_PAGE_ALLOCATOR_H
+#define HUGE_PAGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <new>
+#include <system_error>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+/*
+
+Memory for very large arrays and scratch buffers (billions of elements).
+Random-access passes such as the radix scatter or heapify touch a different page on almost every access. With 4 KB pages the TLB covers
+only a few MB, so most accesses also pay for a page walk. Backing the arrays with 2 MB pages makes the TLB reach 512 times larger.
+
+- mapLargePages() maps anonymous memory with mmap:
+  - Explicit huge pages (MAP_HUGETLB) are tried first when requested. They need pages reserved in /proc/sys/vm/nr_hugepages.
+  - Otherwise, or when none are available, regions of at least 2 MB are aligned to 2 MB and marked with madvise(MADV_HUGEPAGE),
+    so transparent huge pages back them. With transparentHugePages off, nothing is marked.
+  - With NUMA interleaving, the pages are spread round-robin over all memory nodes (mbind MPOL_INTERLEAVE), so a sort that runs on
+    every socket is not limited by the memory bandwidth of one node. This must happen before the pages are first touched.
+    When the kernel rejects the policy, the mapping is released and std::system_error is thrown.
+- smallPageOptions() turns every huge page feature off, mapLargePages() then only maps plain memory.
+- HugePageAllocator is a standard allocator on top of it for std::vector (HugePageVector). Allocations below 2 MB use operator new.
+
+*/
+
+struct LargePageOptions {
+    bool transparentHugePages = true;
+    bool explicitHugePages = false;
+    bool numaInterleave = false;
+};
+
+// Plain 4 KB pages, no madvise and no NUMA policy
+inline LargePageOptions smallPageOptions() {
+    LargePageOptions options;
+    options.transparentHugePages = false;
+    return options;
+}
+
+const size_t SMALL_PAGE_SIZE = 4096;
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+inline size_t roundUpTo(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Number of bytes mapLargePages() maps for a request of bytes
+inline size_t largePageMappingSize(size_t bytes, const LargePageOptions& options) {
+    bool hugePages = options.explicitHugePages || options.transparentHugePages;
+    return roundUpTo(bytes > 0 ? bytes : 1, hugePages && bytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : SMALL_PAGE_SIZE);
+}
+
+// Returns false with errno set when the kernel does not apply the policy, for example without NUMA support
+inline bool interleaveOverNumaNodes(void* data, size_t size) {
+#ifdef SYS_mbind
+    // MPOL_INTERLEAVE from <numaif.h>, over every node allowed for this process
+    const int MPOL_INTERLEAVE_MODE = 3;
+    unsigned long nodeMask[16];
+    for (unsigned long& word : nodeMask) {
+        word = ~0UL;
+    }
+    return syscall(SYS_mbind, data, size, MPOL_INTERLEAVE_MODE, nodeMask, sizeof(nodeMask) * 8, 0) == 0;
+#else
+    (void)data;
+    (void)size;
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
+// Maps at least bytes of zeroed memory, release it with unmapLargePages(data, largePageMappingSize(bytes, options))
+inline void* mapLargePages(size_t bytes, const LargePageOptions& options) {
+    size_t size = largePageMappingSize(bytes, options);
+    void* data = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    if (options.explicitHugePages && size % HUGE_PAGE_SIZE == 0) {
+        data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+
+    if (data == MAP_FAILED) {
+        bool alignToHugePages = options.transparentHugePages && size % HUGE_PAGE_SIZE == 0;
+
+        // Map one huge page more than needed and trim, so the region starts on a 2 MB boundary
+        size_t mappedSize = alignToHugePages ? size + HUGE_PAGE_SIZE : size;
+        void* mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        char* start = static_cast<char*>(mapping);
+        if (alignToHugePages) {
+            char* aligned = reinterpret_cast<char*>(roundUpTo(reinterpret_cast<uintptr_t>(start), HUGE_PAGE_SIZE));
+            if (aligned > start) {
+                munmap(start, aligned - start);
+            }
+            if (start + mappedSize > aligned + size) {
+                munmap(aligned + size, start + mappedSize - (aligned + size));
+            }
+            start = aligned;
+
+#ifdef MADV_HUGEPAGE
+            madvise(start, size, MADV_HUGEPAGE);
+#endif
+        }
+        data = start;
+    }
+
+    if (options.numaInterleave && !interleaveOverNumaNodes(data, size)) {
+        int error = errno;
+        munmap(data, size);
+        throw std::system_error(error, std::generic_category(), "mbind(MPOL_INTERLEAVE)");
+    }
+    return data;
+}
+
+inline void unmapLargePages(void* data, size_t size) {
+    munmap(data, size);
+}
+
+template <typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    HugePageAllocator() = default;
+
+    explicit HugePageAllocator(const LargePageOptions& options) : options(options) {}
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>& other) : options(other.options) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (bytes < HUGE_PAGE_SIZE) {
+            return static_cast<T*>(::operator new(bytes));
+        }
+        return static_cast<T*>(mapLargePages(bytes, options));
+    }
+
+    void deallocate(T* data, size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (bytes < HUGE_PAGE_SIZE) {
+            ::operator delete(data);
+            return;
+        }
+        unmapLargePages(data, largePageMappingSize(bytes, options));
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>& other) const {
+        return options.transparentHugePages == other.options.transparentHugePages &&
+               options.explicitHugePages == other.options.explicitHugePages &&
+               options.numaInterleave == other.options.numaInterleave;
+    }
+
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>& other) const {
+        return !(*this == other);
+    }
+
+    LargePageOptions options;
+};
+
+template <typename T>
+using HugePageVector = std::vector<T, HugePageAllocator<T>>;
+
+#endif
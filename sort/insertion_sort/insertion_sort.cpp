@@ -1,6 +1,9 @@
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <array>
+#include <cstddef>
+#include <vector>
 
 
 /*
@@ -19,24 +22,49 @@ resulting in quadratic time complexity.
    - Insertion Sort is an in-place sorting algorithm, meaning it doesn't require additional memory for sorting and operates directly on the input array.
    - The space complexity is O(1), indicating constant space usage. The amount of extra memory used by the algorithm does not depend on the size of the input array.
 
+Compile-time sorting:
+- insertionSort is constexpr, so it also runs inside the compiler. insertionSorted() sorts a std::array and returns it, which lets constexpr lookup
+  tables be stored already sorted, with no sorting at program startup.
+
 */
-void insertionSort(int arr[], int n) {
-    for (int i_itr = 1; i_itr < n; i_itr++) {
+constexpr void insertionSort(int arr[], size_t n) {
+    for (size_t i_itr = 1; i_itr < n; i_itr++) {
         int key = arr[i_itr];
-        int j_itr = i_itr - 1;
+        size_t j_itr = i_itr;
 
         // Move elements of arr[0..i-1] that are greater than key to one position ahead of their current position
-        while (j_itr >= 0 && arr[j_itr] > key) {
-            arr[j_itr + 1] = arr[j_itr];
+        while (j_itr > 0 && arr[j_itr - 1] > key) {
+            arr[j_itr] = arr[j_itr - 1];
             j_itr = j_itr - 1;
         }
 
-        arr[j_itr + 1] = key;
+        arr[j_itr] = key;
     }
 }
 
-void printArray(int arr[], int size) {
-    for (int i_itr = 0; i_itr < size; i_itr++) {
+// Returns a sorted copy, usable to initialize constexpr tables
+template <size_t N>
+constexpr std::array<int, N> insertionSorted(std::array<int, N> arr) {
+    insertionSort(arr.data(), N);
+    return arr;
+}
+
+template <size_t N>
+constexpr bool isSorted(const std::array<int, N>& arr) {
+    for (size_t i_itr = 1; i_itr < N; i_itr++) {
+        if (arr[i_itr - 1] > arr[i_itr]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Lookup table sorted by the compiler
+constexpr std::array<int, 8> SORTED_TABLE = insertionSorted(std::array<int, 8>{300, 20, 4000, 1, 50000, 600000, 7, 80});
+static_assert(isSorted(SORTED_TABLE), "insertionSorted must sort the table at compile time");
+
+void printArray(const int arr[], size_t size) {
+    for (size_t i_itr = 0; i_itr < size; i_itr++) {
         std::cout << arr[i_itr] << " ";
     }
     std::cout << std::endl;
@@ -54,7 +82,7 @@ int main() {
     int n;
     inputFile >> n;
 
-    int arr[n];
+    std::vector<int> arr(n);
     for (int i_itr = 0; i_itr < n; i_itr++) {
         inputFile >> arr[i_itr];
     }
@@ -62,18 +90,21 @@ int main() {
     inputFile.close();
 
     std::cout << "Unsorted array: ";
-    printArray(arr, n);
+    printArray(arr.data(), arr.size());
 
     // Measure the execution time
     auto start = std::chrono::high_resolution_clock::now();
-    insertionSort(arr, n);
+    insertionSort(arr.data(), arr.size());
     auto end = std::chrono::high_resolution_clock::now();
 
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
 
     std::cout << "Sorted array: ";
-    printArray(arr, n);
+    printArray(arr.data(), arr.size());
     std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
 
+    std::cout << "Lookup table sorted at compile time: ";
+    printArray(SORTED_TABLE.data(), SORTED_TABLE.size());
+
     return 0;
 }
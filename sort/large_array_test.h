@@ -0,0 +1,87 @@
+#ifndef LARGE_ARRAY_TEST_H
+#define LARGE_ARRAY_TEST_H
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include "huge_page_allocator.h"
+
+
+/*
+
+Large array mode shared by the sorting programs, for sizes beyond 2^31 elements:
+
+    ./<sort> N [--interleave]
+
+- N random values are generated into a HugePageVector (see huge_page_allocator.h), sorted, and checked with std::is_sorted.
+- --interleave spreads the pages over all NUMA nodes.
+- N must be a positive decimal number. Anything else prints the usage and fails, so a typo cannot pass as a successful empty sort.
+- The exit code is 0 only when the result is sorted.
+
+*/
+
+// Parses a positive element count. Rejects empty input, signs, trailing characters, overflow and 0.
+inline bool parseElementCount(const char* text, size_t& count) {
+    if (text[0] < '0' || text[0] > '9') {
+        return false;
+    }
+
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || value == 0) {
+        return false;
+    }
+
+    count = static_cast<size_t>(value);
+    return true;
+}
+
+template <typename T>
+T randomValue(std::mt19937_64& generator) {
+    return static_cast<T>(generator());
+}
+
+// Runs the large array mode for argv = {program, N, [--interleave]}. generate(generator) returns one random value,
+// sort(arr, options) sorts the array and may use options for its scratch memory. Returns the exit code.
+template <typename T, typename Generate, typename Sort>
+int runLargeTest(int argc, char* argv[], Generate generate, Sort sort) {
+    size_t n = 0;
+    bool validArguments = argc <= 3 && parseElementCount(argv[1], n) && (argc < 3 || std::string(argv[2]) == "--interleave");
+    if (!validArguments) {
+        std::cerr << "Usage: " << argv[0] << " N [--interleave]   (N > 0 elements)" << std::endl;
+        return 1;
+    }
+
+    LargePageOptions options;
+    options.numaInterleave = argc == 3;
+
+    try {
+        HugePageVector<T> arr(n, T(), HugePageAllocator<T>(options));
+        std::mt19937_64 generator(42);
+        for (T& value : arr) {
+            value = generate(generator);
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        sort(arr, options);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+        bool sorted = std::is_sorted(arr.begin(), arr.end());
+        std::cout << "Sorted " << n << " elements in huge pages: " << duration.count() << " nanoseconds"
+                  << (sorted ? "" : " [NOT SORTED]") << std::endl;
+        return sorted ? 0 : 1;
+    } catch (const std::exception& error) {
+        std::cerr << "Large array test failed: " << error.what() << std::endl;
+        return 1;
+    }
+}
+
+#endif
@@ -1,7 +1,15 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <fstream>
 #include <chrono>
+#include <random>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <string>
+#include "../sort_workspace.h"
+#include "../large_array_test.h"
 
 
 
@@ -22,25 +30,57 @@ and the additional space required is directly proportional to the size of the in
    - Merge Sort has a space complexity of O(n) due to the additional space required for the temporary arrays during the merging process.
    - The additional space is needed to store the two halves of the array being merged.
 
+Scratch Memory:
+- The temporary arrays of every merge come from a SortWorkspace (see ../sort_workspace.h) and are released when the merge returns,
+  so all merges of a sort, and all later sorts, reuse the same n elements of memory instead of allocating two vectors per merge.
+  Without an explicit workspace the calling thread's workspace is used.
+
+Incremental Updates:
+- mergeBatch adds a batch of k new values to an array that is already sorted: only the batch is sorted (O(k log k)), then it is merged into
+  the array from the back. Merging from the back writes every element to its final position directly, so while the array's capacity
+  suffices it grows in place, the only extra buffer is the batch itself, and elements smaller than the smallest new value are never moved.
+  - When the capacity does not suffice, it grows geometrically (at least doubling), so a stream of batches reallocates O(log n) times.
+    A reallocation merges straight into the new storage instead of copying the array first and merging afterwards.
+  - Callers that know how large the array will get reserve() it up front and never reallocate.
+- eraseBatch removes a batch of values (one occurrence per value in the batch) with a tombstone sweep: the sorted batch is walked together
+  with the array, matching elements are skipped and the survivors are compacted in the same pass. Elements before the first deleted
+  value are never moved.
+- Both cost O(n + k log k) per update instead of O(n log n) for sorting everything again.
+
+Fused Grouping:
+- Deduplicating or counting after a sort is one more pass over n elements. Equal values meet in the final merge anyway, so the grouping is
+  done there: both halves are sorted as usual, and the last merge emits one value per run of equal values.
+  - mergeSortDedupInPlace writes only the first element of every run back, so the array shrinks to its distinct values in the same pass.
+  - mergeSortUnique returns the distinct values in sorted order.
+  - mergeSortCount returns every distinct value with its number of occurrences.
+- mergeSortUnique and mergeSortCount sort a copy and leave their input unchanged.
+
+Large Arrays:
+- Indices are ptrdiff_t instead of int, so arrays beyond 2^31 elements can be sorted (right is n - 1, which is -1 for an empty array).
+- The array can use HugePageAllocator and the workspace can map huge pages (see ../huge_page_allocator.h); for billions of elements
+  the merge buffers are as large as the input, so both are backed by 2 MB pages.
+
 */
-void merge(std::vector<int>& arr, int left, int middle, int right) {
-    int n1 = middle - left + 1;
-    int n2 = right - middle;
+template <typename Allocator>
+void merge(std::vector<int, Allocator>& arr, ptrdiff_t left, ptrdiff_t middle, ptrdiff_t right, SortWorkspace& workspace) {
+    ptrdiff_t n1 = middle - left + 1;
+    ptrdiff_t n2 = right - middle;
 
-    // Create temporary arrays
-    std::vector<int> leftArray(n1);
-    std::vector<int> rightArray(n2);
+    // Create temporary arrays, released when the merge returns
+    WorkspaceScope scope(workspace);
+    int* leftArray = workspace.allocate<int>(n1);
+    int* rightArray = workspace.allocate<int>(n2);
 
     // Copy data to temporary arrays leftArray[] and rightArray[]
-    for (int i_itr = 0; i_itr < n1; i_itr++)
+    for (ptrdiff_t i_itr = 0; i_itr < n1; i_itr++)
         leftArray[i_itr] = arr[left + i_itr];
-    for (int j_itr = 0; j_itr < n2; j_itr++)
+    for (ptrdiff_t j_itr = 0; j_itr < n2; j_itr++)
         rightArray[j_itr] = arr[middle + 1 + j_itr];
 
     // Merge the temporary arrays back into arr[left..right]
-    int i = 0; // Initial index of first subarray
-    int j = 0; // Initial index of second subarray
-    int k = left; // Initial index of merged subarray
+    ptrdiff_t i = 0; // Initial index of first subarray
+    ptrdiff_t j = 0; // Initial index of second subarray
+    ptrdiff_t k = left; // Initial index of merged subarray
 
     while (i < n1 && j < n2) {
         if (leftArray[i] <= rightArray[j]) {
@@ -68,18 +108,347 @@ void merge(std::vector<int>& arr, int left, int middle, int right) {
     }
 }
 
-void mergeSort(std::vector<int>& arr, int left, int right) {
+template <typename Allocator>
+void mergeSort(std::vector<int, Allocator>& arr, ptrdiff_t left, ptrdiff_t right, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
     if (left < right) {
         // Same as (left+right)/2, but avoids overflow for large left and right
-        int middle = left + (right - left) / 2;
+        ptrdiff_t middle = left + (right - left) / 2;
 
         // Sort first and second halves
-        mergeSort(arr, left, middle);
-        mergeSort(arr, middle + 1, right);
+        mergeSort(arr, left, middle, workspace);
+        mergeSort(arr, middle + 1, right, workspace);
 
         // Merge the sorted halves
-        merge(arr, left, middle, right);
+        merge(arr, left, middle, right, workspace);
+    }
+}
+
+// Final merge of the two sorted halves arr[0..middle] and arr[middle+1..n-1] that also groups equal values: emit(value, occurrences) is
+// called for every run of equal values. With Unique only the first element of every run is written back. Returns the number of
+// elements written.
+template <bool Unique, typename Allocator, typename Emit>
+size_t mergeGroups(std::vector<int, Allocator>& arr, ptrdiff_t middle, SortWorkspace& workspace, Emit emit) {
+    ptrdiff_t n1 = middle + 1;
+    ptrdiff_t n2 = static_cast<ptrdiff_t>(arr.size()) - n1;
+
+    WorkspaceScope scope(workspace);
+    int* leftArray = workspace.allocate<int>(n1);
+    int* rightArray = workspace.allocate<int>(n2);
+    std::copy(arr.begin(), arr.begin() + n1, leftArray);
+    std::copy(arr.begin() + n1, arr.end(), rightArray);
+
+    size_t k = 0; // Next position to write
+    int current = 0; // Value of the current run
+    size_t runLength = 0;
+
+    // Append the next value of the merged order, closing the current run when the value changes
+    auto take = [&](int value) {
+        if (runLength > 0 && value == current) {
+            runLength++;
+            if (!Unique) {
+                arr[k++] = value;
+            }
+            return;
+        }
+        if (runLength > 0) {
+            emit(current, runLength);
+        }
+        current = value;
+        runLength = 1;
+        arr[k++] = value;
+    };
+
+    ptrdiff_t i = 0; // Next element of the left half
+    ptrdiff_t j = 0; // Next element of the right half
+    while (i < n1 && j < n2) {
+        // The left element goes first on ties
+        if (leftArray[i] <= rightArray[j]) {
+            take(leftArray[i++]);
+        } else {
+            take(rightArray[j++]);
+        }
+    }
+    while (i < n1) {
+        take(leftArray[i++]);
+    }
+    while (j < n2) {
+        take(rightArray[j++]);
+    }
+
+    if (runLength > 0) {
+        emit(current, runLength);
+    }
+    return k;
+}
+
+// Sort the two halves of arr and group equal values during the final merge, see mergeGroups
+template <bool Unique, typename Allocator, typename Emit>
+size_t mergeSortGroups(std::vector<int, Allocator>& arr, SortWorkspace& workspace, Emit emit) {
+    if (arr.empty()) {
+        return 0;
+    }
+
+    // Same split as mergeSort(arr, 0, n - 1)
+    ptrdiff_t right = static_cast<ptrdiff_t>(arr.size()) - 1;
+    ptrdiff_t middle = right / 2;
+    mergeSort(arr, 0, middle, workspace);
+    mergeSort(arr, middle + 1, right, workspace);
+    return mergeGroups<Unique>(arr, middle, workspace, emit);
+}
+
+// Sort arr and remove duplicates, arr keeps one element per distinct value
+template <typename Allocator>
+void mergeSortDedupInPlace(std::vector<int, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    arr.resize(mergeSortGroups<true>(arr, workspace, [](int, size_t) {}));
+}
+
+// Distinct values of arr in sorted order
+template <typename Allocator>
+std::vector<int> mergeSortUnique(const std::vector<int, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    std::vector<int> result(arr.begin(), arr.end());
+    mergeSortDedupInPlace(result, workspace);
+    return result;
+}
+
+// Distinct values of arr in sorted order, each with its number of occurrences
+template <typename Allocator>
+std::vector<std::pair<int, size_t>> mergeSortCount(const std::vector<int, Allocator>& arr,
+                                                   SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    std::vector<int> sorted(arr.begin(), arr.end());
+    std::vector<std::pair<int, size_t>> result;
+    mergeSortGroups<true>(sorted, workspace, [&result](int value, size_t occurrences) {
+        result.emplace_back(value, occurrences);
+    });
+    return result;
+}
+
+// Add the values of batch to the sorted array arr. batch is sorted in place and used as the merge buffer.
+template <typename Allocator>
+void mergeBatch(std::vector<int, Allocator>& arr, std::vector<int>& batch, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    if (batch.empty()) {
+        return;
     }
+
+    // Sort only the new values
+    mergeSort(batch, 0, static_cast<ptrdiff_t>(batch.size()) - 1, workspace);
+
+    ptrdiff_t n1 = arr.size();
+    ptrdiff_t n2 = batch.size();
+
+    // Out of capacity: merge forward into storage with geometric headroom, so the old array is read once and not copied first.
+    // std::merge takes from the first range on equal values, which keeps the existing elements first
+    if (arr.capacity() < static_cast<size_t>(n1 + n2)) {
+        std::vector<int, Allocator> grown(arr.get_allocator());
+        grown.reserve(std::max(static_cast<size_t>(n1 + n2), 2 * arr.capacity()));
+        std::merge(arr.begin(), arr.end(), batch.begin(), batch.end(), std::back_inserter(grown));
+        arr.swap(grown);
+        return;
+    }
+
+    arr.resize(n1 + n2);
+
+    // Merge from the back, every element is written once to its final position
+    ptrdiff_t i = n1 - 1; // Last unmerged element of the sorted array
+    ptrdiff_t j = n2 - 1; // Last unmerged element of the batch
+    ptrdiff_t k = n1 + n2 - 1; // Next position to fill
+
+    while (j >= 0) {
+        // Equal values keep the existing element first
+        if (i >= 0 && arr[i] > batch[j]) {
+            arr[k] = arr[i];
+            i--;
+        } else {
+            arr[k] = batch[j];
+            j--;
+        }
+        k--;
+    }
+
+    // The remaining arr[0..i] are already in place
+}
+
+// Remove one occurrence of every value of batch from the sorted array arr. Returns the number of removed elements.
+template <typename Allocator>
+size_t eraseBatch(std::vector<int, Allocator>& arr, std::vector<int>& batch, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    if (batch.empty() || arr.empty()) {
+        return 0;
+    }
+
+    mergeSort(batch, 0, static_cast<ptrdiff_t>(batch.size()) - 1, workspace);
+
+    // Nothing before the first deleted value moves
+    size_t n = arr.size();
+    size_t read = std::lower_bound(arr.begin(), arr.end(), batch[0]) - arr.begin();
+    size_t write = read;
+    size_t j = 0;
+
+    // Sweep the array and the batch together, a matching pair is a tombstone and is skipped
+    while (read < n) {
+        while (j < batch.size() && batch[j] < arr[read]) {
+            j++;
+        }
+        if (j < batch.size() && batch[j] == arr[read]) {
+            j++;
+            read++;
+        } else {
+            arr[write] = arr[read];
+            write++;
+            read++;
+        }
+    }
+
+    size_t removed = n - write;
+    arr.resize(write);
+    return removed;
+}
+
+// Sort many arrays in a row, as a service does, and report the scratch memory the workspace needed.
+// Returns false when an array is not sorted afterwards
+bool runWorkspaceBenchmark() {
+    const int numArrays = 200;
+    const int arraySize = 100000;
+
+    std::mt19937 generator(42);
+    std::vector<std::vector<int>> arrays(numArrays, std::vector<int>(arraySize));
+    for (std::vector<int>& arr : arrays) {
+        for (int& value : arr) {
+            value = static_cast<int>(generator());
+        }
+    }
+
+    SortWorkspace workspace;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (std::vector<int>& arr : arrays) {
+        mergeSort(arr, 0, arraySize - 1, workspace);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << numArrays << " arrays of " << arraySize << " elements: " << duration.count() << " nanoseconds, "
+              << "SortWorkspace high-water mark " << workspace.highWaterMark() << " bytes, "
+              << workspace.mappings() << " mappings";
+
+    bool allSorted = true;
+    for (const std::vector<int>& arr : arrays) {
+        allSorted = allSorted && std::is_sorted(arr.begin(), arr.end());
+    }
+    std::cout << (allSorted ? "" : " [MISMATCH]") << std::endl;
+    return allSorted;
+}
+
+// Keep a large sorted array up to date with batches of inserts and deletes. Returns false when the result differs from re-sorting
+bool runIncrementalBenchmark() {
+    const int n = 1 << 22;
+    const int batchSize = 100000;
+    const int numUpdates = 5;
+
+    std::mt19937 generator(42);
+    std::vector<int> arr(n);
+    for (int& value : arr) {
+        value = static_cast<int>(generator());
+    }
+    mergeSort(arr, 0, n - 1);
+
+    std::vector<int> resorted = arr;
+    long long resortNanoseconds = 0;
+    long long incrementalNanoseconds = 0;
+
+    for (int update = 0; update < numUpdates; update++) {
+        std::vector<int> inserts(batchSize);
+        for (int& value : inserts) {
+            value = static_cast<int>(generator());
+        }
+
+        // Delete some existing values and a few that are not in the array
+        std::vector<int> deletes(batchSize / 10);
+        for (int& value : deletes) {
+            value = generator() % 4 == 0 ? static_cast<int>(generator()) : arr[generator() % arr.size()];
+        }
+
+        // Baseline: apply the update and sort everything again
+        std::vector<int> resortInserts = inserts;
+        std::vector<int> resortDeletes = deletes;
+        auto start = std::chrono::high_resolution_clock::now();
+        eraseBatch(resorted, resortDeletes);
+        resorted.insert(resorted.end(), resortInserts.begin(), resortInserts.end());
+        mergeSort(resorted, 0, static_cast<ptrdiff_t>(resorted.size()) - 1);
+        auto end = std::chrono::high_resolution_clock::now();
+        resortNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        eraseBatch(arr, deletes);
+        mergeBatch(arr, inserts);
+        end = std::chrono::high_resolution_clock::now();
+        incrementalNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    }
+
+    std::cout << numUpdates << " updates of " << batchSize << " inserts and " << batchSize / 10 << " deletes on "
+              << n << " elements" << std::endl;
+    std::cout << "Full re-sort: " << resortNanoseconds << " nanoseconds" << std::endl;
+    std::cout << "Incremental merge: " << incrementalNanoseconds << " nanoseconds"
+              << (arr == resorted ? "" : " [MISMATCH]") << std::endl;
+    return arr == resorted;
+}
+
+// Group-by workload with many repeated keys: sort followed by a second pass, against grouping in the final merge.
+// Returns false when a fused operator does not match the two-pass result
+bool runGroupingBenchmark() {
+    const int n = 1 << 22;
+    const int numKeys = 1 << 16;
+
+    std::mt19937 generator(42);
+    std::vector<int> data(n);
+    for (int& value : data) {
+        value = static_cast<int>(generator() % numKeys) * 1000;
+    }
+
+    std::vector<int> sorted = data;
+    auto start = std::chrono::high_resolution_clock::now();
+    mergeSort(sorted, 0, n - 1);
+    std::vector<std::pair<int, size_t>> expectedCounts;
+    for (int value : sorted) {
+        if (expectedCounts.empty() || expectedCounts.back().first != value) {
+            expectedCounts.emplace_back(value, 0);
+        }
+        expectedCounts.back().second++;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto countDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    sorted = data;
+    start = std::chrono::high_resolution_clock::now();
+    mergeSort(sorted, 0, n - 1);
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    end = std::chrono::high_resolution_clock::now();
+    auto uniqueDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<std::pair<int, size_t>> counts = mergeSortCount(data);
+    end = std::chrono::high_resolution_clock::now();
+    auto fusedCountDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::vector<int> deduplicated = data;
+    start = std::chrono::high_resolution_clock::now();
+    mergeSortDedupInPlace(deduplicated);
+    end = std::chrono::high_resolution_clock::now();
+    auto dedupDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::vector<int> unique = mergeSortUnique(data);
+
+    std::cout << n << " elements, " << sorted.size() << " distinct" << std::endl;
+    std::cout << "Sort + count pass: " << countDuration.count() << " nanoseconds, mergeSortCount: "
+              << fusedCountDuration.count() << " nanoseconds" << (counts == expectedCounts ? "" : " [MISMATCH]") << std::endl;
+    std::cout << "Sort + std::unique: " << uniqueDuration.count() << " nanoseconds, mergeSortDedupInPlace: "
+              << dedupDuration.count() << " nanoseconds" << (deduplicated == sorted && unique == sorted ? "" : " [MISMATCH]") << std::endl;
+    return counts == expectedCounts && deduplicated == sorted && unique == sorted;
+}
+
+// Returns false when any benchmark result is wrong
+bool runBenchmarks() {
+    bool allMatch = runWorkspaceBenchmark();
+    allMatch = runIncrementalBenchmark() && allMatch;
+    allMatch = runGroupingBenchmark() && allMatch;
+    return allMatch;
 }
 
 void printArray(const std::vector<int>& arr) {
@@ -89,7 +458,18 @@ void printArray(const std::vector<int>& arr) {
     std::cout << std::endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // ./merge_sort N [--interleave] sorts N random values in huge pages, see ../large_array_test.h.
+    // The benchmarks take seconds, so they only run with --benchmark
+    bool benchmark = argc == 2 && std::string(argv[1]) == "--benchmark";
+    if (argc > 1 && !benchmark) {
+        // The merge buffers are as large as the input, so they use huge pages as well
+        return runLargeTest<int>(argc, argv, randomValue<int>, [](HugePageVector<int>& arr, const LargePageOptions& options) {
+            SortWorkspace workspace(options);
+            mergeSort(arr, 0, static_cast<ptrdiff_t>(arr.size()) - 1, workspace);
+        });
+    }
+
     const char* filename = "../input_sort.txt";
     std::ifstream inputFile(filename);
 
@@ -123,5 +503,10 @@ int main() {
     printArray(arr);
     std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
 
+    // A mismatch in the benchmarks fails the run
+    if (benchmark && !runBenchmarks()) {
+        return 1;
+    }
+
     return 0;
 }
@@ -0,0 +1,427 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <stdexcept>
+#include <string>
+
+
+/*
+
+Selection finds the k-th smallest element (k counted from 0) without sorting the whole array, for example the median or the 99th percentile.
+All functions below leave the array partitioned around the selected element: arr[k] holds the k-th smallest value, nothing before it is larger
+and nothing after it is smaller.
+
+1. Introselect:
+   - Quick select: partition around a pivot (median of three) like quick sort, but only continue into the side that contains k.
+   - The partition is three-way (<, ==, > pivot), so arrays with many equal values (latencies rounded to microseconds) do not degrade.
+   - If the recursion gets deeper than 2 log2(n), the pivot is chosen with median of medians (groups of 5) instead, which guarantees
+     that every step removes at least 30% of the elements.
+   - Time complexity: O(n) expected, O(n) worst case thanks to the median of medians fallback.
+   - Space complexity: O(1) for quick select steps, O(log n) for the median of medians recursion.
+
+2. Floyd-Rivest:
+   - For large ranges, first selects recursively inside a small random-looking sample around the expected position of the k-th element.
+     The resulting pivot is very close to the k-th element, so the partition step leaves only a small range to continue with.
+   - Time complexity: n + min(k, n - k) + o(n) comparisons expected, the fastest in practice for large n. O(n^2) worst case.
+   - Space complexity: O(log n) for the sample recursion.
+
+3. Multi-select:
+   - Finds several ranks (for example p50, p99 and p999) in one recursive pass. After each partition the list of wanted ranks is split
+     between the two sides, and sides without a wanted rank are never touched again.
+   - Time complexity: O(n log r) expected for r ranks, instead of O(n r) for r separate selections.
+   - Space complexity: O(log n) for the recursion.
+
+*/
+
+const size_t INSERTION_SORT_THRESHOLD = 16;
+const size_t FLOYD_RIVEST_SAMPLE_THRESHOLD = 600;
+
+void insertionSort(std::vector<int>& arr, size_t left, size_t right) {
+    for (size_t i_itr = left + 1; i_itr <= right; i_itr++) {
+        int key = arr[i_itr];
+        size_t j_itr = i_itr;
+
+        while (j_itr > left && arr[j_itr - 1] > key) {
+            arr[j_itr] = arr[j_itr - 1];
+            j_itr--;
+        }
+
+        arr[j_itr] = key;
+    }
+}
+
+// Three-way partition of arr[low..high] around the value at arr[high], as chosen by the quick sort pivot convention.
+// Returns [first, last], the range holding the elements equal to the pivot.
+std::pair<size_t, size_t> partition(std::vector<int>& arr, size_t low, size_t high) {
+    int pivot = arr[high];
+    size_t lt = low;      // arr[low..lt-1] < pivot
+    size_t gt = high + 1; // arr[gt..high] > pivot
+    size_t i_itr = low;
+
+    while (i_itr < gt) {
+        if (arr[i_itr] < pivot) {
+            std::swap(arr[lt++], arr[i_itr++]);
+        } else if (arr[i_itr] > pivot) {
+            std::swap(arr[i_itr], arr[--gt]);
+        } else {
+            i_itr++;
+        }
+    }
+
+    return {lt, gt - 1};
+}
+
+// Moves the median of arr[low], arr[middle] and arr[high] to arr[high]
+void medianOfThreeToHigh(std::vector<int>& arr, size_t low, size_t high) {
+    size_t middle = low + (high - low) / 2;
+    if (arr[middle] < arr[low]) {
+        std::swap(arr[middle], arr[low]);
+    }
+    if (arr[high] < arr[low]) {
+        std::swap(arr[high], arr[low]);
+    }
+    if (arr[middle] < arr[high]) {
+        std::swap(arr[middle], arr[high]);
+    }
+}
+
+size_t introSelect(std::vector<int>& arr, size_t left, size_t right, size_t k, int depthBudget);
+
+// Moves a pivot chosen by median of medians to arr[high]
+void medianOfMediansToHigh(std::vector<int>& arr, size_t low, size_t high) {
+    // Sort every group of 5 and gather the group medians at the front of the range
+    size_t numGroups = 0;
+    for (size_t groupStart = low; groupStart <= high; groupStart += 5) {
+        size_t groupEnd = std::min(groupStart + 4, high);
+        insertionSort(arr, groupStart, groupEnd);
+        std::swap(arr[low + numGroups], arr[groupStart + (groupEnd - groupStart) / 2]);
+        numGroups++;
+    }
+
+    // The median of the medians, selected with the worst-case linear algorithm
+    size_t median = low + (numGroups - 1) / 2;
+    introSelect(arr, low, low + numGroups - 1, median, 0);
+    std::swap(arr[median], arr[high]);
+}
+
+// Selects the k-th element of arr[left..right]. A depthBudget of 0 always uses median of medians pivots.
+size_t introSelect(std::vector<int>& arr, size_t left, size_t right, size_t k, int depthBudget) {
+    while (right - left >= INSERTION_SORT_THRESHOLD) {
+        if (depthBudget > 0) {
+            depthBudget--;
+            medianOfThreeToHigh(arr, left, right);
+        } else {
+            medianOfMediansToHigh(arr, left, right);
+        }
+
+        std::pair<size_t, size_t> equal = partition(arr, left, right);
+        if (k < equal.first) {
+            right = equal.first - 1;
+        } else if (k > equal.second) {
+            left = equal.second + 1;
+        } else {
+            return k;
+        }
+    }
+
+    insertionSort(arr, left, right);
+    return k;
+}
+
+void checkRank(const std::vector<int>& arr, size_t k) {
+    if (k >= arr.size()) {
+        throw std::out_of_range("rank " + std::to_string(k) + " out of range for " + std::to_string(arr.size()) + " elements");
+    }
+}
+
+int depthLimit(size_t n) {
+    return 2 * static_cast<int>(std::log2(static_cast<double>(std::max<size_t>(n, 2))));
+}
+
+// Returns the k-th smallest element and leaves arr partitioned around it
+int introSelect(std::vector<int>& arr, size_t k) {
+    checkRank(arr, k);
+    introSelect(arr, 0, arr.size() - 1, k, depthLimit(arr.size()));
+    return arr[k];
+}
+
+void floydRivestSelect(std::vector<int>& arr, std::ptrdiff_t left, std::ptrdiff_t right, std::ptrdiff_t k) {
+    while (right > left) {
+        // Narrow down to a sample that very likely contains the k-th element and select inside it first
+        if (right - left > static_cast<std::ptrdiff_t>(FLOYD_RIVEST_SAMPLE_THRESHOLD)) {
+            double n = static_cast<double>(right - left + 1);
+            double i = static_cast<double>(k - left + 1);
+            double z = std::log(n);
+            double s = 0.5 * std::exp(2.0 * z / 3.0);
+            double sd = 0.5 * std::sqrt(z * s * (n - s) / n) * (i < n / 2 ? -1.0 : 1.0);
+            std::ptrdiff_t newLeft = std::max(left, static_cast<std::ptrdiff_t>(k - i * s / n + sd));
+            std::ptrdiff_t newRight = std::min(right, static_cast<std::ptrdiff_t>(k + (n - i) * s / n + sd));
+            floydRivestSelect(arr, newLeft, newRight, k);
+        }
+
+        // Partition arr[left..right] around t = arr[k]
+        int t = arr[k];
+        std::ptrdiff_t i_itr = left;
+        std::ptrdiff_t j_itr = right;
+        std::swap(arr[left], arr[k]);
+        if (arr[right] > t) {
+            std::swap(arr[right], arr[left]);
+        }
+        while (i_itr < j_itr) {
+            std::swap(arr[i_itr], arr[j_itr]);
+            i_itr++;
+            j_itr--;
+            while (arr[i_itr] < t) {
+                i_itr++;
+            }
+            while (arr[j_itr] > t) {
+                j_itr--;
+            }
+        }
+        if (arr[left] == t) {
+            std::swap(arr[left], arr[j_itr]);
+        } else {
+            j_itr++;
+            std::swap(arr[j_itr], arr[right]);
+        }
+
+        // t is now at j_itr, continue on the side holding k
+        if (j_itr <= k) {
+            left = j_itr + 1;
+        }
+        if (k <= j_itr) {
+            right = j_itr - 1;
+        }
+    }
+}
+
+// Returns the k-th smallest element and leaves arr partitioned around it
+int floydRivestSelect(std::vector<int>& arr, size_t k) {
+    checkRank(arr, k);
+    floydRivestSelect(arr, 0, static_cast<std::ptrdiff_t>(arr.size()) - 1, static_cast<std::ptrdiff_t>(k));
+    return arr[k];
+}
+
+// Selects every rank in [firstRank, lastRank) inside arr[left..right]. The ranks must be sorted.
+void multiSelect(std::vector<int>& arr, size_t left, size_t right,
+                 const size_t* firstRank, const size_t* lastRank, int depthBudget) {
+    while (firstRank != lastRank) {
+        if (right - left < INSERTION_SORT_THRESHOLD) {
+            insertionSort(arr, left, right);
+            return;
+        }
+
+        if (depthBudget > 0) {
+            depthBudget--;
+            medianOfThreeToHigh(arr, left, right);
+        } else {
+            medianOfMediansToHigh(arr, left, right);
+        }
+
+        // Split the wanted ranks between the < side, the == range and the > side
+        std::pair<size_t, size_t> equal = partition(arr, left, right);
+        const size_t* firstInEqual = std::lower_bound(firstRank, lastRank, equal.first);
+        const size_t* firstAfterEqual = std::upper_bound(firstInEqual, lastRank, equal.second);
+
+        if (firstRank != firstInEqual) {
+            multiSelect(arr, left, equal.first - 1, firstRank, firstInEqual, depthBudget);
+        }
+
+        // Continue with the > side in this loop
+        firstRank = firstAfterEqual;
+        left = equal.second + 1;
+    }
+}
+
+// Returns the elements at the given ranks and leaves arr partitioned around each of them
+std::vector<int> multiSelect(std::vector<int>& arr, const std::vector<size_t>& ranks) {
+    for (size_t rank : ranks) {
+        checkRank(arr, rank);
+    }
+
+    std::vector<size_t> sortedRanks = ranks;
+    std::sort(sortedRanks.begin(), sortedRanks.end());
+    sortedRanks.erase(std::unique(sortedRanks.begin(), sortedRanks.end()), sortedRanks.end());
+
+    if (!arr.empty()) {
+        multiSelect(arr, 0, arr.size() - 1, sortedRanks.data(), sortedRanks.data() + sortedRanks.size(), depthLimit(arr.size()));
+    }
+
+    std::vector<int> values;
+    for (size_t rank : ranks) {
+        values.push_back(arr[rank]);
+    }
+    return values;
+}
+
+// Rank of the p-th percentile (0 <= p <= 100) in an array of n elements, nearest rank method
+size_t percentileRank(size_t n, double p) {
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * n));
+    return rank == 0 ? 0 : rank - 1;
+}
+
+void printArray(const std::vector<int>& arr) {
+    for (int num : arr) {
+        std::cout << num << " ";
+    }
+    std::cout << std::endl;
+}
+
+// Ranks outside the array must throw instead of reading out of bounds
+bool checkRangeErrors() {
+    auto throwsOutOfRange = [](auto select) {
+        try {
+            select();
+        } catch (const std::out_of_range&) {
+            return true;
+        }
+        return false;
+    };
+
+    std::vector<int> empty;
+    std::vector<int> values = {3, 1, 2};
+    bool ok = throwsOutOfRange([&] { introSelect(empty, 0); }) &&
+              throwsOutOfRange([&] { introSelect(values, 3); }) &&
+              throwsOutOfRange([&] { floydRivestSelect(empty, 0); }) &&
+              throwsOutOfRange([&] { floydRivestSelect(values, 3); }) &&
+              throwsOutOfRange([&] { multiSelect(values, {0, 3}); }) &&
+              throwsOutOfRange([&] { multiSelect(empty, {0}); });
+    if (!ok) {
+        std::cerr << "Range check failed" << std::endl;
+    }
+    return ok;
+}
+
+// Returns false when a selection does not match the sorted reference
+bool runBenchmarks() {
+    const size_t n = 10000000;
+    const double percentiles[] = {50.0, 99.0, 99.9};
+
+    // Latencies in microseconds, log-normally distributed with many repeated values
+    std::mt19937 generator(42);
+    std::lognormal_distribution<double> latencyDistribution(5.0, 1.0);
+    std::vector<int> samples(n);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        samples[i_itr] = static_cast<int>(latencyDistribution(generator));
+    }
+
+    std::vector<size_t> ranks;
+    for (double p : percentiles) {
+        ranks.push_back(percentileRank(n, p));
+    }
+
+    // Reference: sort everything
+    std::vector<int> sorted = samples;
+    auto start = std::chrono::high_resolution_clock::now();
+    std::sort(sorted.begin(), sorted.end());
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    std::cout << "p50/p99/p999 of " << n << " samples:";
+    for (size_t rank : ranks) {
+        std::cout << " " << sorted[rank];
+    }
+    std::cout << std::endl;
+    std::cout << "std::sort: " << duration.count() << " nanoseconds" << std::endl;
+
+    bool allMatch = true;
+    auto timeSingleSelect = [&](const char* name, int (*select)(std::vector<int>&, size_t)) {
+        std::vector<int> arr = samples;
+        bool matches = true;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t rank : ranks) {
+            matches = matches && select(arr, rank) == sorted[rank];
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+        std::cout << name << " (one call per rank): " << duration.count() << " nanoseconds"
+                  << (matches ? "" : " [MISMATCH]") << std::endl;
+        allMatch = allMatch && matches;
+    };
+
+    timeSingleSelect("std::nth_element", [](std::vector<int>& arr, size_t k) {
+        std::nth_element(arr.begin(), arr.begin() + k, arr.end());
+        return arr[k];
+    });
+    timeSingleSelect("Introselect", introSelect);
+    timeSingleSelect("Floyd-Rivest", floydRivestSelect);
+
+    std::vector<int> arr = samples;
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<int> values = multiSelect(arr, ranks);
+    end = std::chrono::high_resolution_clock::now();
+    duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    bool matches = true;
+    for (size_t i_itr = 0; i_itr < ranks.size(); i_itr++) {
+        matches = matches && values[i_itr] == sorted[ranks[i_itr]];
+    }
+    std::cout << "Multi-select (one pass): " << duration.count() << " nanoseconds"
+              << (matches ? "" : " [MISMATCH]") << std::endl;
+    return allMatch && matches;
+}
+
+int main(int argc, char* argv[]) {
+    // The benchmarks take seconds, so they only run with --benchmark
+    bool benchmark = argc == 2 && std::string(argv[1]) == "--benchmark";
+    if (argc > 1 && !benchmark) {
+        std::cerr << "Usage: " << argv[0] << " [--benchmark]" << std::endl;
+        return 1;
+    }
+
+    const char* filename = "../input_sort.txt";
+    std::ifstream inputFile(filename);
+
+    if (!inputFile) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+        return 1;
+    }
+
+    int n;
+    inputFile >> n;
+
+    std::vector<int> arr;
+    int num;
+    while(inputFile >> num){
+        arr.push_back(num);
+    }
+
+    inputFile.close();
+
+    if (arr.empty()) {
+        std::cerr << "No values in file: " << filename << std::endl;
+        return 1;
+    }
+
+    std::cout << "Array: ";
+    printArray(arr);
+
+    // Measure the execution time
+    size_t medianRank = (arr.size() - 1) / 2;
+    auto start = std::chrono::high_resolution_clock::now();
+    int median = introSelect(arr, medianRank);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << "Median: " << median << std::endl;
+    std::cout << "Partitioned array: ";
+    printArray(arr);
+    std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
+
+    if (!checkRangeErrors()) {
+        return 1;
+    }
+
+    // Compare percentile selection with sorting, a mismatch fails the run
+    if (benchmark && !runBenchmarks()) {
+        return 1;
+    }
+
+    return 0;
+}
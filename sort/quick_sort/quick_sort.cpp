@@ -2,6 +2,10 @@
 #include <vector>
 #include <fstream>
 #include <chrono>
+#include <algorithm>
+#include <random>
+#include <cstddef>
+#include "../large_array_test.h"
 
 
 /*
@@ -20,15 +24,22 @@ However, the space complexity is influenced by the depth of the recursive call s
    - In the best case, the space complexity is O(log n) because the algorithm partitions the array in-place.
    - In the worst case, the space complexity can be O(n) due to the unbalanced partitions, requiring a deep recursive call stack.
 
+Large Arrays:
+   - Indices are ptrdiff_t instead of int, so arrays beyond 2^31 elements can be sorted (low - 1 and pivotIndex - 1 may be -1, so the type is signed).
+   - Only the smaller partition is sorted recursively and the larger one in the loop, so the stack depth stays O(log n) even for
+     unbalanced partitions of billions of elements.
+   - Arrays from HugePageVector (see ../huge_page_allocator.h) are backed by 2 MB pages, which reduces TLB misses on large arrays.
+
 */
 
 
 // Function to partition the array and return the index of the pivot
-int partition(std::vector<int>& arr, int low, int high) {
+template <typename Allocator>
+ptrdiff_t partition(std::vector<int, Allocator>& arr, ptrdiff_t low, ptrdiff_t high) {
     int pivot = arr[high]; // Choose the last element as the pivot
-    int i_itr = low - 1; // Index of smaller element
+    ptrdiff_t i_itr = low - 1; // Index of smaller element
 
-    for (int j_itr = low; j_itr < high; j_itr++) {
+    for (ptrdiff_t j_itr = low; j_itr < high; j_itr++) {
         // If the current element is smaller than or equal to the pivot
         if (arr[j_itr] <= pivot) {
             i_itr++;
@@ -40,14 +51,20 @@ int partition(std::vector<int>& arr, int low, int high) {
     return i_itr + 1;
 }
 
-void quickSort(std::vector<int>& arr, int low, int high) {
-    if (low < high) {
+template <typename Allocator>
+void quickSort(std::vector<int, Allocator>& arr, ptrdiff_t low, ptrdiff_t high) {
+    while (low < high) {
         // Partition the array and get the pivot index
-        int pivotIndex = partition(arr, low, high);
-
-        // Recursively sort the sub-arrays
-        quickSort(arr, low, pivotIndex - 1);
-        quickSort(arr, pivotIndex + 1, high);
+        ptrdiff_t pivotIndex = partition(arr, low, high);
+
+        // Recursively sort the smaller sub-array, continue with the larger one
+        if (pivotIndex - low < high - pivotIndex) {
+            quickSort(arr, low, pivotIndex - 1);
+            low = pivotIndex + 1;
+        } else {
+            quickSort(arr, pivotIndex + 1, high);
+            high = pivotIndex - 1;
+        }
     }
 }
 
@@ -58,7 +75,14 @@ void printArray(const std::vector<int>& arr) {
     std::cout << std::endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // ./quick_sort N [--interleave] sorts N random values in huge pages, see ../large_array_test.h
+    if (argc > 1) {
+        return runLargeTest<int>(argc, argv, randomValue<int>, [](HugePageVector<int>& arr, const LargePageOptions&) {
+            quickSort(arr, 0, static_cast<ptrdiff_t>(arr.size()) - 1);
+        });
+    }
+
     const char* filename = "../input_sort.txt";
     std::ifstream inputFile(filename);
 
@@ -3,6 +3,16 @@
 #include <algorithm>
 #include <fstream>
 #include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <string>
+#include "../sort_workspace.h"
+#include "../large_array_test.h"
 
 
 /*
@@ -31,9 +41,44 @@ Additional Details:
   - The count array has a fixed size of 10 (for base 10 digits), and the output array has the same size as the input array.
   - Therefore, the space complexity is O(n + k).
 
+Floating point and 64-bit keys:
+- Keys of other types are mapped to an unsigned integer whose natural order matches the order of the original values, sorted with a
+  binary LSD radix sort (8 or 16 bits per digit), and mapped back.
+  - Unsigned integers (uint64_t) are used as they are.
+  - Signed integers (int64_t) flip the sign bit, so negative values land below non-negative ones.
+  - IEEE-754 floats and doubles flip all bits of negative values (their magnitude order is reversed) and only the sign bit of positive values.
+  - NaNs are moved to the end with std::partition before the transform and are not radix sorted, so every NaN ends up after +infinity,
+    the same way std::sort orders them with a "NaN is largest" comparator. NaNs are never transformed, their sign and payload are kept.
+- A single read pass builds the histograms of all digits, and a digit pass is skipped when every key has the same value in that digit
+  (for example the high bytes of small IDs or timestamps).
+- Time complexity is O(n * w / d) where w is the key width and d the digit width, with 2^d counters per digit.
+- Space complexity is O(n + 2^d): one key buffer and one scratch buffer of n keys, plus the histograms.
+
+Scratch Memory:
+- The output, count and key buffers come from a SortWorkspace (see ../sort_workspace.h), so the digit passes and repeated calls reuse the
+  same memory instead of allocating new vectors. Without an explicit workspace the calling thread's workspace is used.
+
+Large Arrays:
+- Sizes, indices and counts are size_t, so arrays beyond 2^31 elements (and digits that occur more than 2^31 times) are handled.
+- The scatter of every pass writes to 2^d places spread over the whole output buffer, so almost every write of a large sort touches
+  a different page. Arrays from HugePageVector and a workspace created with LargePageOptions (see ../huge_page_allocator.h) are backed
+  by 2 MB pages, which keeps those pages in the TLB.
+
+Fused Grouping:
+- Deduplicating or counting after a sort is another pass over the sorted data. The typed sorts already finish with a pass over the sorted
+  keys (the copy out of the scratch buffer, or the transform back from radix keys), so the grouping is done in that pass instead:
+  - radixSortUnique returns the distinct values in sorted order.
+  - radixSortCount returns every distinct value with its number of occurrences.
+  - radixSortDedupInPlace replaces the array by its distinct values in sorted order.
+- Values are distinct when their radix keys are, that is by bit pattern: -0.0 and +0.0 are different keys, and so are NaNs with different payloads.
+- The fusion only saves the light passes after the sort (NaN partition, transform back, grouping walk), next to a histogram pass and up to
+  8 scatter passes. The gain is small and often within run-to-run noise (see runGroupingBenchmarks), so these operators are about
+  convenience and memory: radixSortUnique and radixSortCount need no sorted copy of their input, unlike a sort followed by a pass.
+
 */
 // Function to find the maximum number in the array
-int findMax(const std::vector<int>& arr) {
+template <typename Allocator>
+int findMax(const std::vector<int, Allocator>& arr) {
     return *std::max_element(arr.begin(), arr.end());
 }
 
@@ -41,13 +86,17 @@ int findMax(const std::vector<int>& arr) {
 void printArray(const std::vector<int>& arr);
 
 // Using counting sort as a subroutine for radix sort
-void countingSort(std::vector<int>& arr, int exp) {
-    const int n = arr.size();
-    std::vector<int> output(n);
-    std::vector<int> count(10, 0);
+template <typename Allocator>
+void countingSort(std::vector<int, Allocator>& arr, int exp, SortWorkspace& workspace) {
+    const size_t n = arr.size();
+
+    // Every pass reuses the memory of the previous one
+    WorkspaceScope scope(workspace);
+    int* output = workspace.allocate<int>(n);
+    size_t count[10] = {0};
 
     // Count the occurrences of each digit at the current place value
-    for (int i_itr = 0; i_itr < n; i_itr++) {
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
         count[(arr[i_itr] / exp) % 10]++;
     }
 
@@ -57,27 +106,527 @@ void countingSort(std::vector<int>& arr, int exp) {
     }
 
     // Build the output array using the count array
-    for (int i_itr = n - 1; i_itr >= 0; i_itr--) {
+    for (size_t i_itr = n; i_itr-- > 0;) {
         output[count[(arr[i_itr] / exp) % 10] - 1] = arr[i_itr];
         count[(arr[i_itr] / exp) % 10]--;
     }
 
     // Copy the sorted elements back to the original array
-    for (int i_itr = 0; i_itr < n; i_itr++) {
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
         arr[i_itr] = output[i_itr];
     }
 }
 
 // Radix Sort function
-void radixSort(std::vector<int>& arr) {
+template <typename Allocator>
+void radixSort(std::vector<int, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    if (arr.empty()) {
+        return;
+    }
+
     int maxElement = findMax(arr);
 
     // Perform counting sort for every digit place (1, 10, 100, ...)
     for (int exp = 1; maxElement / exp > 0; exp *= 10) {
-        countingSort(arr, exp);
+        countingSort(arr, exp, workspace);
     }
 }
 
+// Order preserving transforms between a key type and the unsigned integer that is radix sorted
+inline uint64_t toRadixKey(uint64_t value) {
+    return value;
+}
+
+inline uint64_t toRadixKey(int64_t value) {
+    return static_cast<uint64_t>(value) ^ (uint64_t(1) << 63);
+}
+
+inline uint64_t toRadixKey(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    // Negative: flip all bits, positive: flip only the sign bit
+    uint64_t mask = (bits >> 63) ? ~uint64_t(0) : (uint64_t(1) << 63);
+    return bits ^ mask;
+}
+
+inline uint32_t toRadixKey(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t mask = (bits >> 31) ? ~uint32_t(0) : (uint32_t(1) << 31);
+    return bits ^ mask;
+}
+
+inline void fromRadixKey(uint64_t key, uint64_t& value) {
+    value = key;
+}
+
+inline void fromRadixKey(uint64_t key, int64_t& value) {
+    value = static_cast<int64_t>(key ^ (uint64_t(1) << 63));
+}
+
+inline void fromRadixKey(uint64_t key, double& value) {
+    // A set top bit means the value was positive, so only its sign bit was flipped
+    uint64_t mask = (key >> 63) ? (uint64_t(1) << 63) : ~uint64_t(0);
+    uint64_t bits = key ^ mask;
+    std::memcpy(&value, &bits, sizeof(value));
+}
+
+inline void fromRadixKey(uint32_t key, float& value) {
+    uint32_t mask = (key >> 31) ? (uint32_t(1) << 31) : ~uint32_t(0);
+    uint32_t bits = key ^ mask;
+    std::memcpy(&value, &bits, sizeof(value));
+}
+
+// Binary LSD radix sort of unsigned keys, DigitBits (8 or 16) bits per pass, with scratch as the second buffer.
+// Returns the buffer that holds the sorted keys, keys or scratch depending on the number of executed passes.
+template <typename Key, int DigitBits>
+Key* radixSortKeysInto(Key* keys, Key* scratch, size_t n, SortWorkspace& workspace) {
+    static_assert(DigitBits == 8 || DigitBits == 16, "Digits must be 8 or 16 bits wide");
+
+    constexpr int numBuckets = 1 << DigitBits;
+    constexpr int numPasses = (sizeof(Key) * 8) / DigitBits;
+    constexpr Key digitMask = static_cast<Key>(numBuckets - 1);
+
+    if (n < 2) {
+        return keys;
+    }
+
+    WorkspaceScope scope(workspace);
+
+    // Build the histogram of every digit in a single read pass
+    size_t* count = workspace.allocate<size_t>(static_cast<size_t>(numPasses) * numBuckets);
+    std::fill(count, count + static_cast<size_t>(numPasses) * numBuckets, 0);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        Key key = keys[i_itr];
+        for (int pass = 0; pass < numPasses; pass++) {
+            count[pass * numBuckets + ((key >> (pass * DigitBits)) & digitMask)]++;
+        }
+    }
+
+    Key* source = keys;
+    Key* destination = scratch;
+
+    for (int pass = 0; pass < numPasses; pass++) {
+        size_t* digitCount = &count[pass * numBuckets];
+        const int shift = pass * DigitBits;
+
+        // Skip the pass when every key has the same digit in this place
+        if (digitCount[(source[0] >> shift) & digitMask] == n) {
+            continue;
+        }
+
+        // Turn the counts into the starting offset of every bucket
+        size_t offset = 0;
+        for (int bucket = 0; bucket < numBuckets; bucket++) {
+            size_t bucketSize = digitCount[bucket];
+            digitCount[bucket] = offset;
+            offset += bucketSize;
+        }
+
+        // Scatter the keys, front to back keeps the sort stable
+        for (size_t i_itr = 0; i_itr < n; i_itr++) {
+            Key key = source[i_itr];
+            destination[digitCount[(key >> shift) & digitMask]++] = key;
+        }
+
+        std::swap(source, destination);
+    }
+
+    return source;
+}
+
+template <typename Key, int DigitBits>
+void radixSortKeys(Key* keys, size_t n, SortWorkspace& workspace) {
+    WorkspaceScope scope(workspace);
+    Key* sorted = radixSortKeysInto<Key, DigitBits>(keys, workspace.allocate<Key>(n), n, workspace);
+
+    // An odd number of executed passes leaves the result in the scratch buffer
+    if (sorted != keys) {
+        std::memcpy(keys, sorted, n * sizeof(Key));
+    }
+}
+
+// Moves every NaN to the end of arr unchanged and returns the number of other values, which are left in front
+template <typename T, typename Allocator>
+size_t partitionNaNsToEnd(std::vector<T, Allocator>& arr) {
+    if constexpr (std::is_floating_point<T>::value) {
+        return std::partition(arr.begin(), arr.end(), [](T value) { return !std::isnan(value); }) - arr.begin();
+    } else {
+        return arr.size();
+    }
+}
+
+// Radix sort for any type with an order preserving key transform
+template <int DigitBits = 8, typename T, typename Allocator>
+void radixSortTransformed(std::vector<T, Allocator>& arr, SortWorkspace& workspace) {
+    using Key = decltype(toRadixKey(T()));
+
+    // NaNs have no place in the key order, they stay untouched after all other values
+    const size_t n = partitionNaNsToEnd(arr);
+
+    WorkspaceScope scope(workspace);
+    Key* keys = workspace.allocate<Key>(n);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        keys[i_itr] = toRadixKey(arr[i_itr]);
+    }
+
+    radixSortKeys<Key, DigitBits>(keys, n, workspace);
+
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        fromRadixKey(keys[i_itr], arr[i_itr]);
+    }
+}
+
+// Radix Sort for doubles, floats and 64-bit integers
+template <int DigitBits = 8, typename Allocator>
+void radixSort(std::vector<double, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    radixSortTransformed<DigitBits>(arr, workspace);
+}
+
+template <int DigitBits = 8, typename Allocator>
+void radixSort(std::vector<float, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    radixSortTransformed<DigitBits>(arr, workspace);
+}
+
+template <int DigitBits = 8, typename Allocator>
+void radixSort(std::vector<int64_t, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    radixSortTransformed<DigitBits>(arr, workspace);
+}
+
+template <int DigitBits = 8, typename Allocator>
+void radixSort(std::vector<uint64_t, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    radixSortKeys<uint64_t, DigitBits>(arr.data(), arr.size(), workspace);
+}
+
+// Sorts the radix keys and calls emit(key, occurrences) for every distinct key in ascending order.
+// This walk over the sorted keys takes the place of the copy back, so the grouping costs no extra pass.
+template <typename Key, int DigitBits, typename Emit>
+void radixSortKeyGroups(Key* keys, size_t n, SortWorkspace& workspace, Emit emit) {
+    if (n == 0) {
+        return;
+    }
+
+    WorkspaceScope scope(workspace);
+    const Key* sorted = radixSortKeysInto<Key, DigitBits>(keys, workspace.allocate<Key>(n), n, workspace);
+
+    // emit may overwrite keys behind the walk, so the current key is kept in a register
+    Key current = sorted[0];
+    size_t runStart = 0;
+    for (size_t i_itr = 1; i_itr < n; i_itr++) {
+        Key key = sorted[i_itr];
+        if (key != current) {
+            emit(current, i_itr - runStart);
+            current = key;
+            runStart = i_itr;
+        }
+    }
+    emit(current, n - runStart);
+}
+
+// Calls emit(value, occurrences) for every distinct value of arr in ascending order
+template <int DigitBits, typename T, typename Allocator, typename Emit>
+void radixSortGroups(const std::vector<T, Allocator>& arr, SortWorkspace& workspace, Emit emit) {
+    using Key = decltype(toRadixKey(T()));
+
+    // NaNs are set aside and grouped by bit pattern after all other values
+    WorkspaceScope scope(workspace);
+    Key* keys = workspace.allocate<Key>(arr.size());
+    size_t n = 0;
+    std::vector<Key> nanBits;
+    for (size_t i_itr = 0; i_itr < arr.size(); i_itr++) {
+        if constexpr (std::is_floating_point<T>::value) {
+            if (std::isnan(arr[i_itr])) {
+                Key bits;
+                std::memcpy(&bits, &arr[i_itr], sizeof(bits));
+                nanBits.push_back(bits);
+                continue;
+            }
+        }
+        keys[n++] = toRadixKey(arr[i_itr]);
+    }
+
+    radixSortKeyGroups<Key, DigitBits>(keys, n, workspace, [&emit](Key key, size_t occurrences) {
+        T value;
+        fromRadixKey(key, value);
+        emit(value, occurrences);
+    });
+
+    std::sort(nanBits.begin(), nanBits.end());
+    for (size_t i_itr = 0; i_itr < nanBits.size();) {
+        size_t runEnd = i_itr;
+        while (runEnd < nanBits.size() && nanBits[runEnd] == nanBits[i_itr]) {
+            runEnd++;
+        }
+        T value;
+        std::memcpy(&value, &nanBits[i_itr], sizeof(value));
+        emit(value, runEnd - i_itr);
+        i_itr = runEnd;
+    }
+}
+
+// Distinct values of arr in sorted order, for doubles, floats and 64-bit integers
+template <int DigitBits = 8, typename T, typename Allocator>
+std::vector<T> radixSortUnique(const std::vector<T, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    std::vector<T> result;
+    radixSortGroups<DigitBits>(arr, workspace, [&result](T value, size_t) {
+        result.push_back(value);
+    });
+    return result;
+}
+
+// Distinct values of arr in sorted order, each with its number of occurrences
+template <int DigitBits = 8, typename T, typename Allocator>
+std::vector<std::pair<T, size_t>> radixSortCount(const std::vector<T, Allocator>& arr,
+                                                 SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    std::vector<std::pair<T, size_t>> result;
+    radixSortGroups<DigitBits>(arr, workspace, [&result](T value, size_t occurrences) {
+        result.emplace_back(value, occurrences);
+    });
+    return result;
+}
+
+// Sort arr and remove duplicates, arr keeps one element per distinct value
+template <int DigitBits = 8, typename T, typename Allocator>
+void radixSortDedupInPlace(std::vector<T, Allocator>& arr, SortWorkspace& workspace = SortWorkspace::threadLocal()) {
+    using Key = decltype(toRadixKey(T()));
+
+    size_t size = 0;
+    if constexpr (std::is_same<T, Key>::value) {
+        // Unsigned keys are sorted in place, the distinct keys are written behind the walk
+        radixSortKeyGroups<Key, DigitBits>(arr.data(), arr.size(), workspace, [&arr, &size](Key key, size_t) {
+            arr[size++] = key;
+        });
+    } else {
+        radixSortGroups<DigitBits>(arr, workspace, [&arr, &size](T value, size_t) {
+            arr[size++] = value;
+        });
+    }
+    arr.resize(size);
+}
+
+// Strict weak order used by std::sort that puts every NaN after +infinity
+template <typename T>
+bool lessNaNLast(T a, T b) {
+    if constexpr (std::is_floating_point<T>::value) {
+        if (std::isnan(a)) {
+            return false;
+        }
+        if (std::isnan(b)) {
+            return true;
+        }
+    }
+    return a < b;
+}
+
+// True when b holds exactly the values of a, compared by bit pattern, in any order
+template <typename T>
+bool sameBitPatterns(const std::vector<T>& a, const std::vector<T>& b) {
+    using Key = decltype(toRadixKey(T()));
+    auto bitsOf = [](const std::vector<T>& values) {
+        std::vector<Key> bits(values.size());
+        std::memcpy(bits.data(), values.data(), values.size() * sizeof(T));
+        std::sort(bits.begin(), bits.end());
+        return bits;
+    };
+    return bitsOf(a) == bitsOf(b);
+}
+
+// Sorting must only reorder values: NaNs of either sign and with payloads come back unchanged, after +infinity
+template <typename T>
+bool checkNaNsPreserved() {
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    std::vector<T> values = {1.0, -nan, 2.0, nan, -std::numeric_limits<T>::infinity(), -0.0, std::numeric_limits<T>::infinity()};
+    std::vector<T> sorted = values;
+    radixSort(sorted);
+
+    bool ordered = std::is_sorted(sorted.begin(), sorted.begin() + 5) && std::isnan(sorted[5]) && std::isnan(sorted[6]);
+    bool preserved = sameBitPatterns(values, sorted);
+    if (!ordered || !preserved) {
+        std::cerr << "NaN check failed for " << sizeof(T) * 8 << "-bit floats: "
+                  << (ordered ? "" : "NaNs not last ") << (preserved ? "" : "values changed") << std::endl;
+    }
+    return ordered && preserved;
+}
+
+// Time radixSort against std::sort on the same random data and report the speed up. Returns false when the results differ
+template <int DigitBits, typename T>
+bool benchmarkAgainstStdSort(const char* name, const std::vector<T>& data) {
+    std::vector<T> radixSorted = data;
+    std::vector<T> stdSorted = data;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    radixSort<DigitBits>(radixSorted);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto radixDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    if constexpr (std::is_floating_point<T>::value) {
+        std::sort(stdSorted.begin(), stdSorted.end(), lessNaNLast<T>);
+    } else {
+        std::sort(stdSorted.begin(), stdSorted.end());
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto stdDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    // Both results must agree element by element, a NaN only matches another NaN
+    bool matches = true;
+    for (size_t i_itr = 0; i_itr < data.size(); i_itr++) {
+        if (lessNaNLast(radixSorted[i_itr], stdSorted[i_itr]) || lessNaNLast(stdSorted[i_itr], radixSorted[i_itr])) {
+            matches = false;
+            break;
+        }
+    }
+
+    std::cout << name << " (" << DigitBits << "-bit digits, " << data.size() << " elements): "
+              << "radixSort " << radixDuration.count() << " ns, "
+              << "std::sort " << stdDuration.count() << " ns, "
+              << "speed up " << static_cast<double>(stdDuration.count()) / radixDuration.count() << "x"
+              << (matches ? "" : " [MISMATCH]") << std::endl;
+    return matches;
+}
+
+// Sort followed by a second pass, against the fused operators. Equal means equal radix keys, as in the fused operators.
+// Returns false when a fused operator does not match the two-pass result
+template <int DigitBits, typename T>
+bool benchmarkGrouping(const char* name, const std::vector<T>& data) {
+    auto sameKey = [](T a, T b) {
+        return toRadixKey(a) == toRadixKey(b);
+    };
+
+    std::vector<T> sorted = data;
+    auto start = std::chrono::high_resolution_clock::now();
+    radixSort<DigitBits>(sorted);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto sortDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<std::pair<T, size_t>> expectedCounts;
+    for (size_t i_itr = 0; i_itr < sorted.size(); i_itr++) {
+        if (expectedCounts.empty() || !sameKey(expectedCounts.back().first, sorted[i_itr])) {
+            expectedCounts.emplace_back(sorted[i_itr], 0);
+        }
+        expectedCounts.back().second++;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto countDuration = sortDuration + std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), sameKey), sorted.end());
+    end = std::chrono::high_resolution_clock::now();
+    auto uniqueDuration = sortDuration + std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<std::pair<T, size_t>> counts = radixSortCount<DigitBits>(data);
+    end = std::chrono::high_resolution_clock::now();
+    auto fusedCountDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::vector<T> deduplicated = data;
+    start = std::chrono::high_resolution_clock::now();
+    radixSortDedupInPlace<DigitBits>(deduplicated);
+    end = std::chrono::high_resolution_clock::now();
+    auto dedupDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::vector<T> unique = radixSortUnique<DigitBits>(data);
+
+    bool matches = counts.size() == expectedCounts.size() && unique.size() == sorted.size() && deduplicated.size() == sorted.size();
+    for (size_t i_itr = 0; matches && i_itr < counts.size(); i_itr++) {
+        matches = sameKey(counts[i_itr].first, expectedCounts[i_itr].first) && counts[i_itr].second == expectedCounts[i_itr].second;
+    }
+    for (size_t i_itr = 0; matches && i_itr < sorted.size(); i_itr++) {
+        matches = sameKey(unique[i_itr], sorted[i_itr]) && sameKey(deduplicated[i_itr], sorted[i_itr]);
+    }
+
+    std::cout << name << " (" << DigitBits << "-bit digits, " << data.size() << " elements, " << sorted.size() << " distinct): "
+              << "sort + count pass " << countDuration.count() << " ns, radixSortCount " << fusedCountDuration.count() << " ns, "
+              << "sort + std::unique " << uniqueDuration.count() << " ns, radixSortDedupInPlace " << dedupDuration.count() << " ns"
+              << (matches ? "" : " [MISMATCH]") << std::endl;
+    return matches;
+}
+
+// Group-by workloads with many repeated keys. Returns false when any result is wrong
+bool runGroupingBenchmarks() {
+    const size_t n = 1 << 22;
+    std::mt19937_64 generator(7);
+
+    // Prices rounded to cents repeat often
+    std::vector<double> prices(n);
+    std::normal_distribution<double> priceDistribution(100.0, 20.0);
+    for (double& price : prices) {
+        price = std::round(priceDistribution(generator) * 100.0) / 100.0;
+    }
+    prices[0] = std::numeric_limits<double>::quiet_NaN();
+    prices[1] = -0.0;
+    prices[2] = 0.0;
+
+    std::vector<int64_t> userIds(n);
+    std::vector<uint64_t> sessionIds(n);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        userIds[i_itr] = static_cast<int64_t>(generator() % 65536) - 32768;
+        sessionIds[i_itr] = generator() % (n / 4);
+    }
+
+    bool allMatch = benchmarkGrouping<8>("double prices", prices);
+    allMatch = benchmarkGrouping<16>("double prices", prices) && allMatch;
+    allMatch = benchmarkGrouping<8>("int64_t user IDs", userIds) && allMatch;
+    allMatch = benchmarkGrouping<16>("int64_t user IDs", userIds) && allMatch;
+    allMatch = benchmarkGrouping<8>("uint64_t session IDs", sessionIds) && allMatch;
+    allMatch = benchmarkGrouping<16>("uint64_t session IDs", sessionIds) && allMatch;
+    return allMatch;
+}
+
+// Returns false when any result is wrong
+bool runTypedBenchmarks() {
+    const size_t n = 1 << 22;
+    std::mt19937_64 generator(42);
+
+    std::vector<double> prices(n);
+    std::normal_distribution<double> priceDistribution(0.0, 1000.0);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        prices[i_itr] = priceDistribution(generator);
+    }
+    // A few special values to exercise the NaN aware ordering
+    prices[0] = std::numeric_limits<double>::quiet_NaN();
+    prices[1] = -std::numeric_limits<double>::quiet_NaN();
+    prices[2] = std::numeric_limits<double>::infinity();
+    prices[3] = -std::numeric_limits<double>::infinity();
+    prices[4] = -0.0;
+
+    std::vector<float> floats(n);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        floats[i_itr] = static_cast<float>(prices[i_itr]);
+    }
+
+    std::vector<uint64_t> ids(n);
+    std::vector<int64_t> signedValues(n);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        ids[i_itr] = generator();
+        signedValues[i_itr] = static_cast<int64_t>(generator());
+    }
+
+    // Timestamps only vary in their low bits, so most digit passes are skipped
+    std::vector<uint64_t> timestamps(n);
+    const uint64_t epochNanoseconds = 1700000000ULL * 1000000000ULL;
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        timestamps[i_itr] = epochNanoseconds + (generator() & 0xFFFFFFFFULL);
+    }
+
+    bool allMatch = benchmarkAgainstStdSort<8>("double", prices);
+    allMatch = benchmarkAgainstStdSort<16>("double", prices) && allMatch;
+    allMatch = benchmarkAgainstStdSort<8>("float", floats) && allMatch;
+    allMatch = benchmarkAgainstStdSort<16>("float", floats) && allMatch;
+    allMatch = benchmarkAgainstStdSort<8>("int64_t", signedValues) && allMatch;
+    allMatch = benchmarkAgainstStdSort<16>("int64_t", signedValues) && allMatch;
+    allMatch = benchmarkAgainstStdSort<8>("uint64_t", ids) && allMatch;
+    allMatch = benchmarkAgainstStdSort<16>("uint64_t", ids) && allMatch;
+    allMatch = benchmarkAgainstStdSort<8>("uint64_t timestamps", timestamps) && allMatch;
+    allMatch = benchmarkAgainstStdSort<16>("uint64_t timestamps", timestamps) && allMatch;
+
+    std::cout << "SortWorkspace high-water mark: " << SortWorkspace::threadLocal().highWaterMark() << " bytes" << std::endl;
+    return allMatch;
+}
+
 // Function to print an array
 void printArray(const std::vector<int>& arr) {
     for (int num : arr) {
@@ -86,7 +635,18 @@ void printArray(const std::vector<int>& arr) {
     std::cout << std::endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // ./radix_sort N [--interleave] sorts N random values in huge pages, see ../large_array_test.h.
+    // The benchmarks take seconds, so they only run with --benchmark
+    bool benchmark = argc == 2 && std::string(argv[1]) == "--benchmark";
+    if (argc > 1 && !benchmark) {
+        // 64-bit keys; the scatter buffer is as large as the input, so it uses huge pages as well
+        return runLargeTest<uint64_t>(argc, argv, randomValue<uint64_t>, [](HugePageVector<uint64_t>& arr, const LargePageOptions& options) {
+            SortWorkspace workspace(options);
+            radixSort(arr, workspace);
+        });
+    }
+
     const char* filename = "../input_sort.txt";
     std::ifstream inputFile(filename);
 
@@ -120,5 +680,19 @@ int main() {
     printArray(arr);
     std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
 
+    if (!checkNaNsPreserved<double>() || !checkNaNsPreserved<float>()) {
+        return 1;
+    }
+
+    // Compare the typed radix sorts with std::sort, and the fused grouping operators with a sort followed by a second pass.
+    // A mismatch fails the run
+    if (benchmark) {
+        bool allMatch = runTypedBenchmarks();
+        allMatch = runGroupingBenchmarks() && allMatch;
+        if (!allMatch) {
+            return 1;
+        }
+    }
+
     return 0;
 }
@@ -0,0 +1,706 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <queue>
+#include <atomic>
+#include <memory>
+#include <cstdlib>
+#include <climits>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <cerrno>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/*
+
+Distributed Sample Sort splits the input into shards, one per process, and lets the processes cooperate so that afterwards
+process 0 holds the smallest keys, process 1 the next ones and so on, each shard sorted.
+Here the processes are local (fork), which lets several memory controllers and caches work on one sort, and the data moves through a
+pluggable Transport so the same driver can later run over a real network.
+
+Steps:
+   1. Every process sorts its own shard with the in-core sort.
+   2. Every process picks evenly spaced samples from its sorted shard and sends them to all other processes.
+   3. All processes sort the same set of samples and choose the same P - 1 global splitters from it.
+   4. Every process cuts its sorted shard at the splitters and sends piece p to process p (all-to-all exchange).
+   5. Every process merges the P sorted pieces it received with a k-way merge.
+
+Transports:
+   - SharedMemoryTransport: a shared anonymous mapping holds a count matrix and a data area. Senders write straight into the receivers'
+     inboxes and a process-shared barrier separates the phases, so every element is copied once per exchange. The barrier can be aborted,
+     so processes waiting for a failed one give up instead of waiting forever.
+   - SocketTransport: a full mesh of Unix domain socket pairs. Messages are length prefixed and sent with non-blocking sockets and poll(),
+     so two processes sending large pieces to each other at the same time cannot deadlock.
+
+1. Time Complexity:
+   - Local sort: O((n/P) log(n/P)) per process.
+   - Sampling and splitter selection: O(s P log(s P)) per process for s samples per process, independent of n.
+   - Exchange: O(n/P) per process when the splitters balance the load.
+   - Merge: O((n/P) log P) per process.
+   - With oversampling, no process receives much more than n/P elements with high probability. Many equal keys can still land on one process.
+
+2. Space Complexity:
+   - O(n/P) per process for the received pieces and the merged output, plus the transport buffers (O(n) shared for the shared memory transport).
+
+*/
+
+// Moves data between cooperating processes. Implementations are created before fork() and attached to a rank in each child.
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    // Called in the child process after fork()
+    virtual void attach(int rank) = 0;
+
+    virtual int rank() const = 0;
+    virtual int size() const = 0;
+
+    // Send sendBuffers[p] to process p and return the buffer received from every process, indexed by sender
+    virtual std::vector<std::vector<int>> allToAll(const std::vector<std::vector<int>>& sendBuffers) = 0;
+
+    // Called in the parent once all workers are forked, releases what only the workers use
+    virtual void detachParent() {}
+
+    // Make the pending and all later exchanges fail in every process, so no process waits for a failed one
+    virtual void abort() = 0;
+};
+
+void throwSystemError(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+class SharedMemoryTransport : public Transport {
+public:
+    // capacity is the largest number of elements moved by a single allToAll across all processes
+    SharedMemoryTransport(int numProcesses, size_t capacity) : numProcesses(numProcesses), capacity(capacity) {
+        size_t countBytes = static_cast<size_t>(numProcesses) * numProcesses * sizeof(size_t);
+        mappingSize = sizeof(Header) + countBytes + capacity * sizeof(int);
+
+        void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            throwSystemError("mmap");
+        }
+
+        header = new (mapping) Header();
+        counts = reinterpret_cast<size_t*>(header + 1);
+        data = reinterpret_cast<int*>(counts + static_cast<size_t>(numProcesses) * numProcesses);
+    }
+
+    ~SharedMemoryTransport() override {
+        munmap(header, mappingSize);
+    }
+
+    void attach(int rank) override {
+        processRank = rank;
+    }
+
+    int rank() const override {
+        return processRank;
+    }
+
+    int size() const override {
+        return numProcesses;
+    }
+
+    std::vector<std::vector<int>> allToAll(const std::vector<std::vector<int>>& sendBuffers) override {
+        // Publish how much this process sends to everyone
+        for (int p = 0; p < numProcesses; p++) {
+            count(processRank, p) = sendBuffers[p].size();
+        }
+        wait();
+
+        // Inboxes are laid out by receiver, and inside an inbox by sender
+        size_t total = 0;
+        std::vector<size_t> inboxStart(numProcesses);
+        std::vector<size_t> writeOffset(numProcesses);
+        for (int receiver = 0; receiver < numProcesses; receiver++) {
+            inboxStart[receiver] = total;
+            for (int sender = 0; sender < numProcesses; sender++) {
+                if (sender == processRank) {
+                    writeOffset[receiver] = total;
+                }
+                total += count(sender, receiver);
+            }
+        }
+        if (total > capacity) {
+            throw std::runtime_error("SharedMemoryTransport: exchange larger than the shared data area");
+        }
+
+        for (int p = 0; p < numProcesses; p++) {
+            std::memcpy(data + writeOffset[p], sendBuffers[p].data(), sendBuffers[p].size() * sizeof(int));
+        }
+        wait();
+
+        std::vector<std::vector<int>> received(numProcesses);
+        size_t readOffset = inboxStart[processRank];
+        for (int sender = 0; sender < numProcesses; sender++) {
+            size_t n = count(sender, processRank);
+            received[sender].assign(data + readOffset, data + readOffset + n);
+            readOffset += n;
+        }
+
+        // Nobody may overwrite the counts or the data area until everyone has read it
+        wait();
+        return received;
+    }
+
+    void abort() override {
+        header->aborted.store(true, std::memory_order_release);
+    }
+
+private:
+    // Lock-free atomics work across processes in a shared mapping
+    struct Header {
+        std::atomic<int> arrived{0};
+        std::atomic<int> generation{0};
+        std::atomic<bool> aborted{false};
+    };
+
+    size_t& count(int sender, int receiver) {
+        return counts[static_cast<size_t>(sender) * numProcesses + receiver];
+    }
+
+    // Barrier over all processes. Throws when the exchange was aborted, a process that died can never arrive.
+    void wait() {
+        int generation = header->generation.load(std::memory_order_acquire);
+        if (header->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == numProcesses) {
+            // Last to arrive: reset the count for the next phase and release the others
+            header->arrived.store(0, std::memory_order_relaxed);
+            header->generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+
+        for (int spins = 0; header->generation.load(std::memory_order_acquire) == generation; spins++) {
+            if (header->aborted.load(std::memory_order_acquire)) {
+                throw std::runtime_error("SharedMemoryTransport: exchange aborted");
+            }
+            // Spin briefly for short phases, then sleep so waiting does not take the CPU from the sorting processes
+            if (spins > 1000) {
+                usleep(50);
+            }
+        }
+    }
+
+    int numProcesses;
+    int processRank = 0;
+    size_t capacity;
+    size_t mappingSize;
+    Header* header;
+    size_t* counts;
+    int* data;
+};
+
+class SocketTransport : public Transport {
+public:
+    explicit SocketTransport(int numProcesses) : numProcesses(numProcesses),
+        sockets(static_cast<size_t>(numProcesses) * numProcesses, -1) {
+        for (int a = 0; a < numProcesses; a++) {
+            for (int b = a + 1; b < numProcesses; b++) {
+                int pair[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+                    throwSystemError("socketpair");
+                }
+                socketAt(a, b) = pair[0];
+                socketAt(b, a) = pair[1];
+            }
+        }
+    }
+
+    ~SocketTransport() override {
+        closeAll();
+    }
+
+    void attach(int rank) override {
+        processRank = rank;
+
+        // Keep only this process's ends of the mesh
+        for (int a = 0; a < numProcesses; a++) {
+            for (int b = 0; b < numProcesses; b++) {
+                int& fd = socketAt(a, b);
+                if (fd >= 0 && a != rank) {
+                    close(fd);
+                    fd = -1;
+                }
+            }
+        }
+
+        for (int p = 0; p < numProcesses; p++) {
+            int fd = socketAt(rank, p);
+            if (fd >= 0) {
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            }
+        }
+    }
+
+    int rank() const override {
+        return processRank;
+    }
+
+    int size() const override {
+        return numProcesses;
+    }
+
+    // Peers see the parent's ends of the mesh as open until it closes them, and would never notice a worker that died
+    void detachParent() override {
+        closeAll();
+    }
+
+    // Peers waiting on this process see the connection close and fail
+    void abort() override {
+        closeAll();
+    }
+
+    std::vector<std::vector<int>> allToAll(const std::vector<std::vector<int>>& sendBuffers) override {
+        std::vector<std::vector<int>> received(numProcesses);
+        received[processRank] = sendBuffers[processRank];
+
+        // Every message is a 64-bit element count followed by the elements
+        std::vector<Stream> outgoing(numProcesses);
+        std::vector<Stream> incoming(numProcesses);
+        for (int p = 0; p < numProcesses; p++) {
+            if (p == processRank) {
+                continue;
+            }
+            outgoing[p].length = sendBuffers[p].size();
+            outgoing[p].data = const_cast<int*>(sendBuffers[p].data());
+            incoming[p].pending = true;
+            outgoing[p].pending = true;
+        }
+
+        std::vector<pollfd> pollSet;
+        std::vector<int> peers;
+        while (true) {
+            pollSet.clear();
+            peers.clear();
+            for (int p = 0; p < numProcesses; p++) {
+                short events = (outgoing[p].pending ? POLLOUT : 0) | (incoming[p].pending ? POLLIN : 0);
+                if (events != 0) {
+                    pollSet.push_back({socketAt(processRank, p), events, 0});
+                    peers.push_back(p);
+                }
+            }
+            if (pollSet.empty()) {
+                break;
+            }
+
+            if (poll(pollSet.data(), pollSet.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throwSystemError("poll");
+            }
+
+            for (size_t i_itr = 0; i_itr < pollSet.size(); i_itr++) {
+                int p = peers[i_itr];
+                int fd = pollSet[i_itr].fd;
+                if (pollSet[i_itr].revents & (POLLOUT | POLLERR)) {
+                    sendSome(fd, outgoing[p]);
+                }
+                if (pollSet[i_itr].revents & (POLLIN | POLLHUP | POLLERR)) {
+                    receiveSome(fd, incoming[p], received[p]);
+                }
+            }
+        }
+
+        return received;
+    }
+
+private:
+    // Progress of one length prefixed message
+    struct Stream {
+        uint64_t length = 0;
+        int* data = nullptr;
+        size_t bytesDone = 0;
+        bool pending = false;
+    };
+
+    void closeAll() {
+        for (int& fd : sockets) {
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    int& socketAt(int a, int b) {
+        return sockets[static_cast<size_t>(a) * numProcesses + b];
+    }
+
+    // Pointer to and size of the part of the message starting at bytesDone
+    static std::pair<char*, size_t> remaining(Stream& stream) {
+        if (stream.bytesDone < sizeof(stream.length)) {
+            return {reinterpret_cast<char*>(&stream.length) + stream.bytesDone, sizeof(stream.length) - stream.bytesDone};
+        }
+        size_t dataDone = stream.bytesDone - sizeof(stream.length);
+        return {reinterpret_cast<char*>(stream.data) + dataDone, stream.length * sizeof(int) - dataDone};
+    }
+
+    static void sendSome(int fd, Stream& stream) {
+        while (stream.pending) {
+            std::pair<char*, size_t> chunk = remaining(stream);
+            ssize_t sent = send(fd, chunk.first, chunk.second, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                    return;
+                }
+                throwSystemError("send");
+            }
+            stream.bytesDone += sent;
+            stream.pending = stream.bytesDone < sizeof(stream.length) + stream.length * sizeof(int);
+        }
+    }
+
+    static void receiveSome(int fd, Stream& stream, std::vector<int>& buffer) {
+        while (stream.pending) {
+            bool headerDone = stream.bytesDone >= sizeof(stream.length);
+            std::pair<char*, size_t> chunk = remaining(stream);
+            if (chunk.second > 0) {
+                ssize_t got = recv(fd, chunk.first, chunk.second, 0);
+                if (got < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                        return;
+                    }
+                    throwSystemError("recv");
+                }
+                if (got == 0) {
+                    throw std::runtime_error("SocketTransport: peer closed the connection");
+                }
+                stream.bytesDone += got;
+            }
+
+            // Size the buffer as soon as the length is known
+            if (!headerDone && stream.bytesDone >= sizeof(stream.length)) {
+                buffer.resize(stream.length);
+                stream.data = buffer.data();
+            }
+            stream.pending = stream.bytesDone < sizeof(stream.length) + stream.length * sizeof(int);
+        }
+    }
+
+    int numProcesses;
+    int processRank = 0;
+    std::vector<int> sockets;
+};
+
+// Samples taken per process and per destination process
+const size_t OVERSAMPLING = 32;
+
+// Merge sorted runs into one sorted array with a min-heap of run heads
+std::vector<int> kWayMerge(const std::vector<std::vector<int>>& runs) {
+    size_t total = 0;
+    for (const std::vector<int>& run : runs) {
+        total += run.size();
+    }
+
+    using Head = std::pair<int, size_t>; // (value, run index)
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    std::vector<size_t> position(runs.size(), 0);
+    for (size_t r = 0; r < runs.size(); r++) {
+        if (!runs[r].empty()) {
+            heads.push({runs[r][0], r});
+        }
+    }
+
+    std::vector<int> output;
+    output.reserve(total);
+    while (!heads.empty()) {
+        Head head = heads.top();
+        heads.pop();
+        output.push_back(head.first);
+
+        size_t r = head.second;
+        if (++position[r] < runs[r].size()) {
+            heads.push({runs[r][position[r]], r});
+        }
+    }
+
+    return output;
+}
+
+// Sort the shards of all processes as one array. On return, shard holds this process's part of the global order.
+void distributedSampleSort(std::vector<int>& shard, Transport& transport) {
+    const int numProcesses = transport.size();
+
+    // 1. Sort the local shard in core
+    std::sort(shard.begin(), shard.end());
+
+    // 2. Send evenly spaced samples of the sorted shard to every process
+    std::vector<int> samples;
+    if (!shard.empty()) {
+        size_t numSamples = OVERSAMPLING * numProcesses;
+        for (size_t i_itr = 0; i_itr < numSamples; i_itr++) {
+            samples.push_back(shard[(i_itr * shard.size()) / numSamples]);
+        }
+    }
+    std::vector<std::vector<int>> sampleBuffers(numProcesses, samples);
+    std::vector<std::vector<int>> receivedSamples = transport.allToAll(sampleBuffers);
+
+    // 3. Every process chooses the same splitters from the same samples
+    std::vector<int> allSamples;
+    for (const std::vector<int>& received : receivedSamples) {
+        allSamples.insert(allSamples.end(), received.begin(), received.end());
+    }
+    std::sort(allSamples.begin(), allSamples.end());
+
+    std::vector<int> splitters;
+    for (int p = 1; p < numProcesses && !allSamples.empty(); p++) {
+        splitters.push_back(allSamples[(p * allSamples.size()) / numProcesses]);
+    }
+
+    // 4. Cut the sorted shard at the splitters, piece p holds the keys in (splitters[p - 1], splitters[p]]
+    std::vector<std::vector<int>> pieces(numProcesses);
+    auto pieceBegin = shard.begin();
+    for (int p = 0; p < numProcesses; p++) {
+        auto pieceEnd = p < static_cast<int>(splitters.size())
+                            ? std::upper_bound(pieceBegin, shard.end(), splitters[p])
+                            : shard.end();
+        pieces[p].assign(pieceBegin, pieceEnd);
+        pieceBegin = pieceEnd;
+    }
+    shard.clear();
+    shard.shrink_to_fit();
+
+    std::vector<std::vector<int>> runs = transport.allToAll(pieces);
+    pieces.clear();
+
+    // 5. Merge the sorted runs received from all processes
+    shard = kWayMerge(runs);
+}
+
+enum class TransportKind {
+    SharedMemory,
+    Socket
+};
+
+// Fork numProcesses workers, sort data across them and return the sorted result in the calling process
+std::vector<int> runDistributedSort(const std::vector<int>& data, int numProcesses, TransportKind kind) {
+    const size_t n = data.size();
+
+    // The largest exchange moves either every element once or every sample to every process
+    std::unique_ptr<Transport> transport;
+    if (kind == TransportKind::SharedMemory) {
+        size_t sampleExchange = OVERSAMPLING * numProcesses * numProcesses * numProcesses;
+        transport.reset(new SharedMemoryTransport(numProcesses, std::max(n, sampleExchange)));
+    } else {
+        transport.reset(new SocketTransport(numProcesses));
+    }
+
+    // The workers write their sorted parts back into a shared result array
+    size_t resultBytes = std::max<size_t>(n, 1) * sizeof(int);
+    void* resultMapping = mmap(nullptr, resultBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (resultMapping == MAP_FAILED) {
+        throwSystemError("mmap");
+    }
+    int* result = static_cast<int*>(resultMapping);
+
+    // Stop all remaining workers: first let them fail on their own, then kill the ones that are not waiting on an exchange
+    std::vector<pid_t> workers;
+    auto stopWorkers = [&transport, &workers]() {
+        transport->abort();
+        for (pid_t pid : workers) {
+            kill(pid, SIGKILL);
+        }
+        for (pid_t pid : workers) {
+            waitpid(pid, nullptr, 0);
+        }
+        workers.clear();
+    };
+
+    for (int rank = 0; rank < numProcesses; rank++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            int forkError = errno;
+            stopWorkers();
+            munmap(resultMapping, resultBytes);
+            errno = forkError;
+            throwSystemError("fork");
+        }
+
+        if (pid == 0) {
+            int status = 0;
+            try {
+                transport->attach(rank);
+
+                std::vector<int> shard(data.begin() + (rank * n) / numProcesses, data.begin() + ((rank + 1) * n) / numProcesses);
+                distributedSampleSort(shard, *transport);
+
+                // Exchange the part sizes to find where this part starts in the result. A part may hold more than 2^31 elements,
+                // so the 64-bit size is sent as its low and high 32-bit halves.
+                uint64_t partSize = shard.size();
+                std::vector<int> encodedSize = {static_cast<int>(static_cast<uint32_t>(partSize)),
+                                                static_cast<int>(static_cast<uint32_t>(partSize >> 32))};
+                std::vector<std::vector<int>> sizes(numProcesses, encodedSize);
+                std::vector<std::vector<int>> allSizes = transport->allToAll(sizes);
+                size_t offset = 0;
+                for (int p = 0; p < rank; p++) {
+                    offset += static_cast<uint64_t>(static_cast<uint32_t>(allSizes[p][0])) |
+                              (static_cast<uint64_t>(static_cast<uint32_t>(allSizes[p][1])) << 32);
+                }
+                std::memcpy(result + offset, shard.data(), shard.size() * sizeof(int));
+            } catch (const std::exception& error) {
+                std::cerr << "Worker " << rank << ": " << error.what() << std::endl;
+                transport->abort();
+                status = 1;
+            }
+            _exit(status);
+        }
+
+        workers.push_back(pid);
+    }
+    transport->detachParent();
+
+    // Reap the workers in the order they finish. The first one that fails or dies stops all others, which could otherwise wait
+    // for it forever.
+    bool failed = false;
+    while (!workers.empty()) {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        auto worker = std::find(workers.begin(), workers.end(), pid);
+        if (worker == workers.end()) {
+            continue;
+        }
+        workers.erase(worker);
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed = true;
+            stopWorkers();
+        }
+    }
+
+    std::vector<int> sorted(result, result + n);
+    munmap(resultMapping, resultBytes);
+
+    if (failed) {
+        throw std::runtime_error("distributed sort: a worker process failed");
+    }
+    return sorted;
+}
+
+void printArray(const std::vector<int>& arr) {
+    for (int num : arr) {
+        std::cout << num << " ";
+    }
+    std::cout << std::endl;
+}
+
+// Returns false when a transport does not match std::sort
+bool runBenchmarks(int numProcesses) {
+    const size_t n = 1 << 24;
+    std::mt19937 generator(42);
+    std::vector<int> data(n);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        data[i_itr] = static_cast<int>(generator());
+    }
+
+    std::vector<int> reference = data;
+    auto start = std::chrono::high_resolution_clock::now();
+    std::sort(reference.begin(), reference.end());
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    std::cout << "std::sort, " << n << " elements: " << duration.count() << " nanoseconds" << std::endl;
+
+    const TransportKind kinds[] = {TransportKind::SharedMemory, TransportKind::Socket};
+    const char* names[] = {"shared memory", "Unix domain sockets"};
+    bool allMatch = true;
+    for (int i_itr = 0; i_itr < 2; i_itr++) {
+        start = std::chrono::high_resolution_clock::now();
+        std::vector<int> sorted = runDistributedSort(data, numProcesses, kinds[i_itr]);
+        end = std::chrono::high_resolution_clock::now();
+        duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+        std::cout << "Sample sort, " << numProcesses << " processes over " << names[i_itr] << ": "
+                  << duration.count() << " nanoseconds" << (sorted == reference ? "" : " [MISMATCH]") << std::endl;
+        allMatch = allMatch && sorted == reference;
+    }
+    return allMatch;
+}
+
+int main(int argc, char* argv[]) {
+    // ./sample_sort [processes] [--benchmark]: 4 cooperating processes unless given, the benchmarks take seconds and only run on request
+    int numProcesses = 4;
+    bool benchmark = false;
+    for (int i_itr = 1; i_itr < argc; i_itr++) {
+        if (std::string(argv[i_itr]) == "--benchmark" && !benchmark) {
+            benchmark = true;
+            continue;
+        }
+
+        // The process count comes first and is a positive decimal number
+        errno = 0;
+        char* end = nullptr;
+        long value = std::strtol(argv[i_itr], &end, 10);
+        bool validCount = i_itr == 1 && argv[i_itr][0] >= '0' && argv[i_itr][0] <= '9' && *end == '\0' && errno == 0 &&
+                          value >= 1 && value <= INT_MAX;
+        if (!validCount) {
+            std::cerr << "Usage: " << argv[0] << " [processes] [--benchmark]   (processes > 0)" << std::endl;
+            return 1;
+        }
+        numProcesses = static_cast<int>(value);
+    }
+
+    const char* filename = "../input_sort.txt";
+    std::ifstream inputFile(filename);
+
+    if (!inputFile) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+        return 1;
+    }
+
+    int n;
+    inputFile >> n;
+
+    std::vector<int> arr;
+    int num;
+    while(inputFile >> num){
+        arr.push_back(num);
+    }
+
+    inputFile.close();
+
+    std::cout << "Unsorted array: ";
+    printArray(arr);
+
+    // A failed worker makes the sort throw instead of hang
+    try {
+        // Measure the execution time
+        auto start = std::chrono::high_resolution_clock::now();
+        arr = runDistributedSort(arr, numProcesses, TransportKind::SharedMemory);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+        std::cout << "Sorted array: ";
+        printArray(arr);
+        std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
+
+        // Compare both transports with a single process std::sort, a mismatch fails the run
+        if (benchmark && !runBenchmarks(numProcesses)) {
+            return 1;
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,306 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <string>
+
+
+/*
+
+Segmented Sort sorts many independent arrays (segments) stored back to back in one flat buffer. Segment s is data[offsets[s] .. offsets[s + 1] - 1].
+Calling a sort once per segment pays the call, dispatch and branch misprediction costs for every segment, which dominates for segments of a
+few dozen elements. Here the whole batch is one call:
+
+   1. Binning: the buffer is processed in windows of consecutive segments. Inside a window the segments are grouped by length with a
+      counting sort on the bin number, keeping their buffer order inside a bin. Segments of up to 8 elements get one bin per exact length.
+   2. Length-specialized kernels run over each bin:
+      - 2 to 8 elements: fixed optimal sorting networks (branch-free compare-exchanges).
+      - up to 32 elements: insertion sort.
+      - longer segments: std::sort.
+      Running the same kernel over a whole bin keeps branch prediction and the instruction cache warm.
+   3. The threads take windows from a shared counter. A window's data stays in cache while all of its bins are processed, and the next
+      segment of a bin is prefetched while the current one is sorted.
+
+1. Time Complexity:
+   - O(n + m) for the binning of m segments holding n elements in total.
+   - Per segment of length L: O(1) for networks, O(L^2) for insertion sort (L <= 32), O(L log L) for longer segments.
+
+2. Space Complexity:
+   - O(window) per thread for the binned segment lists. The segments are sorted in place.
+
+*/
+
+// Optimal sorting networks for 2 to 8 elements, one comparator per row
+const unsigned char NETWORK_2[][2] = {{0, 1}};
+const unsigned char NETWORK_3[][2] = {{0, 2}, {0, 1}, {1, 2}};
+const unsigned char NETWORK_4[][2] = {{0, 2}, {1, 3}, {0, 1}, {2, 3}, {1, 2}};
+const unsigned char NETWORK_5[][2] = {{0, 3}, {1, 4}, {0, 2}, {1, 3}, {0, 1}, {2, 4}, {1, 2}, {3, 4}, {2, 3}};
+const unsigned char NETWORK_6[][2] = {{0, 5}, {1, 3}, {2, 4}, {1, 2}, {3, 4}, {0, 3}, {2, 5}, {0, 1}, {2, 3}, {4, 5}, {1, 2}, {3, 4}};
+const unsigned char NETWORK_7[][2] = {{0, 6}, {2, 3}, {4, 5}, {0, 2}, {1, 4}, {3, 6}, {0, 1}, {2, 5}, {3, 4}, {1, 2}, {4, 6},
+                                      {2, 3}, {4, 5}, {1, 2}, {3, 4}, {5, 6}};
+const unsigned char NETWORK_8[][2] = {{0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}, {0, 1}, {2, 3}, {4, 5},
+                                      {6, 7}, {2, 4}, {3, 5}, {1, 4}, {3, 6}, {1, 2}, {3, 4}, {5, 6}};
+
+const int MAX_NETWORK_LENGTH = 8;
+const size_t MAX_INSERTION_LENGTH = 32;
+
+// Segments binned and sorted together, small enough for their data to stay in the L2 cache
+const size_t WINDOW_SEGMENTS = 1024;
+
+// Branch-free compare-exchange
+inline void compareExchange(int* arr, int i, int j) {
+    int a = arr[i];
+    int b = arr[j];
+    arr[i] = std::min(a, b);
+    arr[j] = std::max(a, b);
+}
+
+// Sorts Length elements in registers, the unrolled comparators compile to min/max instructions without branches
+template <size_t Length, size_t Size>
+inline void applyNetwork(int* arr, const unsigned char (&network)[Size][2]) {
+    int values[Length];
+    for (size_t i_itr = 0; i_itr < Length; i_itr++) {
+        values[i_itr] = arr[i_itr];
+    }
+
+#pragma GCC unroll 32
+    for (size_t i_itr = 0; i_itr < Size; i_itr++) {
+        compareExchange(values, network[i_itr][0], network[i_itr][1]);
+    }
+
+    for (size_t i_itr = 0; i_itr < Length; i_itr++) {
+        arr[i_itr] = values[i_itr];
+    }
+}
+
+void networkSort(int* arr, size_t n) {
+    switch (n) {
+        case 2: applyNetwork<2>(arr, NETWORK_2); break;
+        case 3: applyNetwork<3>(arr, NETWORK_3); break;
+        case 4: applyNetwork<4>(arr, NETWORK_4); break;
+        case 5: applyNetwork<5>(arr, NETWORK_5); break;
+        case 6: applyNetwork<6>(arr, NETWORK_6); break;
+        case 7: applyNetwork<7>(arr, NETWORK_7); break;
+        case 8: applyNetwork<8>(arr, NETWORK_8); break;
+        default: break;
+    }
+}
+
+void insertionSort(int* arr, size_t n) {
+    for (size_t i_itr = 1; i_itr < n; i_itr++) {
+        int key = arr[i_itr];
+        size_t j_itr = i_itr;
+
+        while (j_itr > 0 && arr[j_itr - 1] > key) {
+            arr[j_itr] = arr[j_itr - 1];
+            j_itr--;
+        }
+
+        arr[j_itr] = key;
+    }
+}
+
+// Segments of up to MAX_NETWORK_LENGTH elements are binned by their exact length, so every bin runs a single network
+const int BIN_INSERTION = MAX_NETWORK_LENGTH + 1;
+const int BIN_LARGE = MAX_NETWORK_LENGTH + 2;
+const int NUM_BINS = MAX_NETWORK_LENGTH + 3;
+
+inline int binOf(size_t length) {
+    if (length <= MAX_NETWORK_LENGTH) {
+        return static_cast<int>(length);
+    }
+    return length <= MAX_INSERTION_LENGTH ? BIN_INSERTION : BIN_LARGE;
+}
+
+// Sort the segments listed in segments[begin..end) with the kernel of one bin
+void sortBin(int bin, int* data, const std::vector<size_t>& offsets, const size_t* segments, size_t begin, size_t end) {
+    for (size_t i_itr = begin; i_itr < end; i_itr++) {
+        size_t segment = segments[i_itr];
+        int* arr = data + offsets[segment];
+        size_t length = offsets[segment + 1] - offsets[segment];
+
+        if (i_itr + 1 < end) {
+            __builtin_prefetch(data + offsets[segments[i_itr + 1]], 1);
+        }
+
+        if (bin < BIN_INSERTION) {
+            networkSort(arr, length);
+        } else if (bin == BIN_INSERTION) {
+            insertionSort(arr, length);
+        } else {
+            std::sort(arr, arr + length);
+        }
+    }
+}
+
+// Bin the segments [firstSegment, lastSegment) by length and run every bin's kernel over them
+void sortWindow(int* data, const std::vector<size_t>& offsets, size_t firstSegment, size_t lastSegment, std::vector<size_t>& segments) {
+    // Counting sort of the segments by bin, stable so every bin lists its segments in buffer order
+    size_t binStart[NUM_BINS + 1] = {0};
+    for (size_t segment = firstSegment; segment < lastSegment; segment++) {
+        binStart[binOf(offsets[segment + 1] - offsets[segment]) + 1]++;
+    }
+    for (int bin = 0; bin < NUM_BINS; bin++) {
+        binStart[bin + 1] += binStart[bin];
+    }
+
+    segments.resize(lastSegment - firstSegment);
+    size_t position[NUM_BINS];
+    std::copy(binStart, binStart + NUM_BINS, position);
+    for (size_t segment = firstSegment; segment < lastSegment; segment++) {
+        segments[position[binOf(offsets[segment + 1] - offsets[segment])]++] = segment;
+    }
+
+    // Segments of 0 or 1 elements are already sorted
+    for (int bin = 2; bin < NUM_BINS; bin++) {
+        sortBin(bin, data, offsets, segments.data(), binStart[bin], binStart[bin + 1]);
+    }
+}
+
+// Sort every segment data[offsets[s] .. offsets[s + 1] - 1]. offsets has one entry more than there are segments.
+void segmentedSort(std::vector<int>& data, const std::vector<size_t>& offsets, int numThreads = 0) {
+    if (offsets.size() < 2) {
+        return;
+    }
+    const size_t numSegments = offsets.size() - 1;
+    const size_t numWindows = (numSegments + WINDOW_SEGMENTS - 1) / WINDOW_SEGMENTS;
+
+    if (numThreads <= 0) {
+        numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    numThreads = static_cast<int>(std::min<size_t>(numThreads, numWindows));
+
+    // Threads take windows from a shared counter
+    std::atomic<size_t> nextWindow(0);
+    auto worker = [&]() {
+        std::vector<size_t> segments;
+        for (size_t window = nextWindow++; window < numWindows; window = nextWindow++) {
+            size_t firstSegment = window * WINDOW_SEGMENTS;
+            size_t lastSegment = std::min(firstSegment + WINDOW_SEGMENTS, numSegments);
+            sortWindow(data.data(), offsets, firstSegment, lastSegment, segments);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int thread = 1; thread < numThreads; thread++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+void printSegments(const std::vector<int>& data, const std::vector<size_t>& offsets) {
+    for (size_t segment = 0; segment + 1 < offsets.size(); segment++) {
+        std::cout << "[ ";
+        for (size_t i_itr = offsets[segment]; i_itr < offsets[segment + 1]; i_itr++) {
+            std::cout << data[i_itr] << " ";
+        }
+        std::cout << "] ";
+    }
+    std::cout << std::endl;
+}
+
+// Returns false when the segmented sort does not match std::sort
+bool runBenchmarks() {
+    // Per-user event lists: mostly short, some up to 200 elements
+    const size_t numSegments = 1000000;
+    std::mt19937 generator(42);
+    std::geometric_distribution<size_t> lengthDistribution(1.0 / 24.0);
+
+    std::vector<size_t> offsets(1, 0);
+    for (size_t segment = 0; segment < numSegments; segment++) {
+        size_t length = std::min<size_t>(4 + lengthDistribution(generator), 200);
+        offsets.push_back(offsets.back() + length);
+    }
+
+    std::vector<int> data(offsets.back());
+    for (int& value : data) {
+        value = static_cast<int>(generator());
+    }
+
+    // Baseline: one sort call per segment
+    std::vector<int> reference = data;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t segment = 0; segment < numSegments; segment++) {
+        std::sort(reference.begin() + offsets[segment], reference.begin() + offsets[segment + 1]);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << numSegments << " segments, " << data.size() << " elements" << std::endl;
+    std::cout << "std::sort per segment: " << duration.count() << " nanoseconds, "
+              << numSegments * 1e9 / duration.count() << " segments per second" << std::endl;
+
+    std::vector<int> arr = data;
+    start = std::chrono::high_resolution_clock::now();
+    segmentedSort(arr, offsets);
+    end = std::chrono::high_resolution_clock::now();
+    duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << "Segmented sort: " << duration.count() << " nanoseconds, "
+              << numSegments * 1e9 / duration.count() << " segments per second"
+              << (arr == reference ? "" : " [MISMATCH]") << std::endl;
+    return arr == reference;
+}
+
+int main(int argc, char* argv[]) {
+    // The benchmarks take seconds, so they only run with --benchmark
+    bool benchmark = argc == 2 && std::string(argv[1]) == "--benchmark";
+    if (argc > 1 && !benchmark) {
+        std::cerr << "Usage: " << argv[0] << " [--benchmark]" << std::endl;
+        return 1;
+    }
+
+    const char* filename = "../input_sort.txt";
+    std::ifstream inputFile(filename);
+
+    if (!inputFile) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+        return 1;
+    }
+
+    int n;
+    inputFile >> n;
+
+    std::vector<int> arr;
+    int num;
+    while(inputFile >> num){
+        arr.push_back(num);
+    }
+
+    inputFile.close();
+
+    // Cut the input into segments of 4 elements, the last one may be shorter
+    std::vector<size_t> offsets;
+    for (size_t i_itr = 0; i_itr < arr.size(); i_itr += 4) {
+        offsets.push_back(i_itr);
+    }
+    offsets.push_back(arr.size());
+
+    std::cout << "Unsorted segments: ";
+    printSegments(arr, offsets);
+
+    // Measure the execution time
+    auto start = std::chrono::high_resolution_clock::now();
+    segmentedSort(arr, offsets);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << "Sorted segments: ";
+    printSegments(arr, offsets);
+    std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
+
+    // Compare with one sort call per segment, a mismatch fails the run
+    if (benchmark && !runBenchmarks()) {
+        return 1;
+    }
+
+    return 0;
+}
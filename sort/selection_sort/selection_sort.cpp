@@ -1,6 +1,8 @@
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <cstddef>
+#include <vector>
 
 
 /*
@@ -25,11 +27,11 @@ void swap(int &a, int &b) {
     b = temp;
 }
 
-void selectionSort(int arr[], int n) {
-    for (int i_itr = 0; i_itr < n - 1; i_itr++) {
+void selectionSort(int arr[], size_t n) {
+    for (size_t i_itr = 0; i_itr + 1 < n; i_itr++) {
         // Find the minimum element in the unsorted part of the array
-        int minIndex = i_itr;
-        for (int j_itr = i_itr + 1; j_itr < n; j_itr++) {
+        size_t minIndex = i_itr;
+        for (size_t j_itr = i_itr + 1; j_itr < n; j_itr++) {
             if (arr[j_itr] < arr[minIndex]) {
                 minIndex = j_itr;
             }
@@ -40,8 +42,8 @@ void selectionSort(int arr[], int n) {
     }
 }
 
-void printArray(int arr[], int size) {
-    for (int i_itr= 0; i_itr < size; i_itr++) {
+void printArray(const int arr[], size_t size) {
+    for (size_t i_itr = 0; i_itr < size; i_itr++) {
         std::cout << arr[i_itr] << " ";
     }
     std::cout << std::endl;
@@ -59,7 +61,7 @@ int main() {
     int n;
     inputFile >> n;
 
-    int arr[n];
+    std::vector<int> arr(n);
     for (int i_itr = 0; i_itr < n; i_itr++) {
         inputFile >> arr[i_itr];
     }
@@ -67,17 +69,17 @@ int main() {
     inputFile.close();
 
     std::cout << "Unsorted array: ";
-    printArray(arr, n);
+    printArray(arr.data(), arr.size());
 
     // Measure the execution time
     auto start = std::chrono::high_resolution_clock::now();
-    selectionSort(arr, n);
+    selectionSort(arr.data(), arr.size());
     auto end = std::chrono::high_resolution_clock::now();
 
     auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
 
     std::cout << "Sorted array: ";
-    printArray(arr, n);
+    printArray(arr.data(), arr.size());
     std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
 
     return 0;
@@ -2,6 +2,8 @@
 #include <vector>
 #include <fstream>
 #include <chrono>
+#include <array>
+#include <cstddef>
 
 
 /*
@@ -22,24 +24,26 @@ The Pratt sequence, in particular, achieves O(n log n) average-case time complex
    - Shell Sort is an in-place sorting algorithm, meaning it does not use additional memory proportional to the size of the input array.
    - The space complexity is O(1), indicating constant space usage.
 
-*/
+Compile-time sorting:
+- The sort works on a plain array and is constexpr, so it also runs inside the compiler. shellSorted() sorts a std::array and returns it,
+  which lets constexpr lookup tables be stored already sorted, with no sorting at program startup.
 
+*/
 
-void shellSort(std::vector<int>& arr) {
-    int n = arr.size();
 
+constexpr void shellSort(int arr[], size_t n) {
     // Start with a large gap and reduce it until gap becomes 1
-    for (int gap = n / 2; gap > 0; gap /= 2) {
+    for (size_t gap = n / 2; gap > 0; gap /= 2) {
         // Do a gapped insertion sort for this gap size.
         // The first gap elements arr[0..gap-1] are already in gapped order.
         // Keep adding one more element until the entire array is gap sorted.
-        for (int i_itr = gap; i_itr < n; i_itr++) {
+        for (size_t i_itr = gap; i_itr < n; i_itr++) {
             // Add arr[i] to the elements that have been gap sorted
             // Save arr[i] in temp and make a hole at position i
             int temp = arr[i_itr];
 
             // Shift the elements in the sorted part to make room for temp
-            int j_itr;
+            size_t j_itr = i_itr;
             for (j_itr = i_itr; j_itr >= gap && arr[j_itr - gap] > temp; j_itr -= gap) {
                 arr[j_itr] = arr[j_itr - gap];
             }
@@ -50,7 +54,34 @@ void shellSort(std::vector<int>& arr) {
     }
 }
 
-void printArray(const std::vector<int>& arr) {
+void shellSort(std::vector<int>& arr) {
+    shellSort(arr.data(), arr.size());
+}
+
+// Returns a sorted copy, usable to initialize constexpr tables
+template <size_t N>
+constexpr std::array<int, N> shellSorted(std::array<int, N> arr) {
+    shellSort(arr.data(), N);
+    return arr;
+}
+
+template <size_t N>
+constexpr bool isSorted(const std::array<int, N>& arr) {
+    for (size_t i_itr = 1; i_itr < N; i_itr++) {
+        if (arr[i_itr - 1] > arr[i_itr]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Lookup table sorted by the compiler
+constexpr std::array<int, 16> SORTED_TABLE = shellSorted(std::array<int, 16>{
+    97, 13, 61, 2, 89, 31, 5, 73, 43, 17, 53, 3, 29, 11, 67, 7});
+static_assert(isSorted(SORTED_TABLE), "shellSorted must sort the table at compile time");
+
+template <typename Array>
+void printArray(const Array& arr) {
     for (int num : arr) {
         std::cout << num << " ";
     }
@@ -91,5 +122,8 @@ int main() {
     printArray(arr);
     std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
 
+    std::cout << "Lookup table sorted at compile time: ";
+    printArray(SORTED_TABLE);
+
     return 0;
 }
@@ -0,0 +1,231 @@
+#ifndef SORT_WORKSPACE_H
+#define SORT_WORKSPACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include "huge_page_allocator.h"
+
+
+/*
+
+SortWorkspace is a growable arena for the scratch buffers of the sorting algorithms (count arrays, output arrays, merge buffers).
+Sorting thousands of arrays per second with a fresh std::vector per call pays for malloc/free and for the page faults of touching new memory
+every time. A workspace keeps its memory between calls, so after the first few calls no scratch memory is allocated at all.
+
+- Allocations are bump-pointer allocations, 64-byte (cache line) aligned.
+- A WorkspaceScope releases everything allocated inside it when it goes out of scope, so nested calls reuse the same memory.
+- When a request does not fit, a new block is mapped. Once the workspace is empty again the blocks are replaced by a single block of the
+  high-water mark size, so a workspace reaches a steady state with one block and no further mappings.
+- Blocks are mapped with mapLargePages() (see huge_page_allocator.h). By default they use plain pages; a workspace created with
+  LargePageOptions backs large blocks with explicit or transparent 2 MB pages and can interleave them over NUMA nodes.
+- shrinkTo(bytes) gives memory back once nothing is in use, trim() unmaps everything. A workspace with a retain limit (setRetainLimit())
+  shrinks to it by itself whenever it becomes empty, so one huge sort does not pin its scratch memory for the rest of the program.
+- SortWorkspace::threadLocal() returns a per-thread workspace, used by the algorithms when no workspace is passed. It keeps at most
+  THREAD_LOCAL_RETAIN_LIMIT bytes between calls; pass an own workspace to keep more.
+- highWaterMark() reports the largest number of bytes in use at once, to size workspaces up front with reserve().
+
+*/
+
+class SortWorkspace {
+public:
+    static const size_t ALIGNMENT = 64;
+    static const size_t THREAD_LOCAL_RETAIN_LIMIT = 64 << 20;
+
+    SortWorkspace() : options(smallPageOptions()) {}
+
+    explicit SortWorkspace(const LargePageOptions& options) : options(options) {}
+
+    SortWorkspace(const LargePageOptions& options, size_t retainLimit) : options(options), retainLimit(retainLimit) {}
+
+    ~SortWorkspace() {
+        for (Block& block : blocks) {
+            unmapBlock(block);
+        }
+    }
+
+    SortWorkspace(const SortWorkspace&) = delete;
+    SortWorkspace& operator=(const SortWorkspace&) = delete;
+
+    // Scratch space for count elements of T, valid until the enclosing WorkspaceScope ends
+    template <typename T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocateBytes(count * sizeof(T)));
+    }
+
+    // Make sure bytes can be allocated without mapping more memory
+    void reserve(size_t bytes) {
+        if (inUse == 0 && bytes > capacity()) {
+            replaceBlocks(bytes);
+        }
+    }
+
+    size_t highWaterMark() const {
+        return maxInUse;
+    }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const Block& block : blocks) {
+            total += block.size;
+        }
+        return total;
+    }
+
+    // Keep at most bytes mapped: the leading blocks that fit stay, the rest are unmapped. Nothing new is mapped, so giving memory
+    // back never costs a mapping. Only possible when nothing is in use; returns false otherwise
+    bool shrinkTo(size_t bytes) {
+        if (inUse != 0) {
+            return false;
+        }
+
+        size_t keep = 0;
+        size_t kept = 0;
+        while (keep < blocks.size() && kept + blocks[keep].size <= bytes) {
+            kept += blocks[keep].size;
+            keep++;
+        }
+        for (size_t i_itr = keep; i_itr < blocks.size(); i_itr++) {
+            unmapBlock(blocks[i_itr]);
+        }
+        blocks.resize(keep);
+        current = 0;
+        recentMaxInUse = 0;
+        return true;
+    }
+
+    bool trim() {
+        return shrinkTo(0);
+    }
+
+    // Largest capacity kept once the workspace is empty again, larger blocks are unmapped when the last scope ends
+    void setRetainLimit(size_t bytes) {
+        retainLimit = bytes;
+        if (inUse == 0 && capacity() > retainLimit) {
+            shrinkTo(retainLimit);
+        }
+    }
+
+    // Number of blocks mapped over the lifetime of the workspace
+    size_t mappings() const {
+        return numMappings;
+    }
+
+    static SortWorkspace& threadLocal() {
+        static thread_local SortWorkspace workspace(smallPageOptions(), THREAD_LOCAL_RETAIN_LIMIT);
+        return workspace;
+    }
+
+private:
+    friend class WorkspaceScope;
+
+    struct Block {
+        char* data;
+        size_t size;
+        size_t used;
+    };
+
+    void* allocateBytes(size_t bytes) {
+        bytes = roundUpTo(bytes, ALIGNMENT);
+
+        // Move on to the next block when the current one is full, map a new one when there is none left
+        while (current < blocks.size() && blocks[current].size - blocks[current].used < bytes) {
+            current++;
+        }
+        if (current == blocks.size()) {
+            // Grow geometrically so a growing workload needs few blocks
+            size_t total = capacity();
+            blocks.push_back(mapBlock(bytes > total ? bytes : total));
+        }
+
+        Block& block = blocks[current];
+        void* result = block.data + block.used;
+        block.used += bytes;
+        inUse += bytes;
+        if (inUse > maxInUse) {
+            maxInUse = inUse;
+        }
+        if (inUse > recentMaxInUse) {
+            recentMaxInUse = inUse;
+        }
+        return result;
+    }
+
+    // Allocation position, restored when a scope ends
+    struct Mark {
+        size_t block;
+        size_t used;
+        size_t inUse;
+    };
+
+    Mark mark() const {
+        return {current, current < blocks.size() ? blocks[current].used : 0, inUse};
+    }
+
+    void release(const Mark& mark) {
+        for (size_t i_itr = mark.block + 1; i_itr < blocks.size(); i_itr++) {
+            blocks[i_itr].used = 0;
+        }
+        if (mark.block < blocks.size()) {
+            blocks[mark.block].used = mark.used;
+        }
+        current = mark.block;
+        inUse = mark.inUse;
+
+        // Once empty, give back what exceeds the retain limit, or merge the blocks into one of the high-water mark size
+        if (inUse == 0 && capacity() > retainLimit) {
+            shrinkTo(retainLimit);
+        } else if (inUse == 0 && blocks.size() > 1) {
+            replaceBlocks(recentMaxInUse);
+        }
+    }
+
+    // Replace all blocks by one block of at least bytes, only when nothing is in use
+    void replaceBlocks(size_t bytes) {
+        for (Block& block : blocks) {
+            unmapBlock(block);
+        }
+        blocks.clear();
+        blocks.push_back(mapBlock(bytes));
+        current = 0;
+    }
+
+    Block mapBlock(size_t bytes) {
+        void* data = mapLargePages(bytes, options);
+        numMappings++;
+        return {static_cast<char*>(data), largePageMappingSize(bytes, options), 0};
+    }
+
+    static void unmapBlock(Block& block) {
+        unmapLargePages(block.data, block.size);
+    }
+
+    LargePageOptions options;
+    std::vector<Block> blocks;
+    size_t current = 0;
+    size_t inUse = 0;
+    size_t maxInUse = 0;
+    size_t recentMaxInUse = 0;
+    size_t retainLimit = SIZE_MAX;
+    size_t numMappings = 0;
+};
+
+// Releases everything allocated from the workspace during its lifetime
+class WorkspaceScope {
+public:
+    explicit WorkspaceScope(SortWorkspace& workspace) : workspace(workspace), start(workspace.mark()) {}
+
+    ~WorkspaceScope() {
+        workspace.release(start);
+    }
+
+    WorkspaceScope(const WorkspaceScope&) = delete;
+    WorkspaceScope& operator=(const WorkspaceScope&) = delete;
+
+private:
+    SortWorkspace& workspace;
+    SortWorkspace::Mark start;
+};
+
+#endif
@@ -0,0 +1,260 @@
+#include <iostream>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <fstream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <utility>
+
+
+/*
+
+A sorting network is a fixed sequence of compare-exchange steps (comparators) that sorts any input of a given size N. The sequence only depends on N,
+so it can be generated at compile time, and sorting an array of compile-time size N becomes a straight line of min/max instructions:
+no loops, no data dependent branches and the same memory accesses for every input.
+
+Generator:
+   - The comparators of Batcher's odd-even merge sort are generated by a constexpr function into a std::array of index pairs.
+     Sizes that are not a power of two use the network of the next power of two without the comparators that reach past the end.
+   - networkSort<N>() expands the comparator list with a fold expression over std::index_sequence, so every comparator becomes
+     inline code with constant indices.
+   - Everything is constexpr, so lookup tables declared constexpr are sorted by the compiler with zero startup cost.
+
+1. Time Complexity:
+   - O(N log^2 N) comparators, executed unconditionally. For small N (up to a few dozen) this beats comparison sorts because there are no
+     branch mispredictions.
+
+2. Space Complexity:
+   - O(1) at run time, the comparator list only exists at compile time.
+
+*/
+
+struct Comparator {
+    size_t first;
+    size_t second;
+};
+
+// Calls visit(i, j) for every comparator of Batcher's odd-even merge sort on n elements
+template <typename Visitor>
+constexpr void forEachComparator(size_t n, Visitor visit) {
+    for (size_t p = 1; p < n; p <<= 1) {
+        for (size_t k = p; k >= 1; k >>= 1) {
+            for (size_t j = k % p; j + k < n; j += 2 * k) {
+                for (size_t i = 0; i < k && i + j + k < n; i++) {
+                    // Only compare elements that belong to the same merge of two sorted runs of length p
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        visit(i + j, i + j + k);
+                    }
+                }
+            }
+        }
+    }
+}
+
+constexpr size_t comparatorCount(size_t n) {
+    size_t count = 0;
+    forEachComparator(n, [&count](size_t, size_t) { count++; });
+    return count;
+}
+
+template <size_t N>
+constexpr std::array<Comparator, comparatorCount(N)> generateNetwork() {
+    std::array<Comparator, comparatorCount(N)> network{};
+    size_t next = 0;
+    forEachComparator(N, [&network, &next](size_t i, size_t j) {
+        network[next].first = i;
+        network[next].second = j;
+        next++;
+    });
+    return network;
+}
+
+template <size_t N>
+struct SortingNetwork {
+    static constexpr std::array<Comparator, comparatorCount(N)> comparators = generateNetwork<N>();
+};
+
+// Branch-free compare-exchange, the smaller value ends up at index i
+constexpr void compareExchange(int* arr, size_t i, size_t j) {
+    int a = arr[i];
+    int b = arr[j];
+    arr[i] = a < b ? a : b;
+    arr[j] = a < b ? b : a;
+}
+
+template <size_t N, size_t... Indices>
+constexpr void applyNetwork(int* arr, std::index_sequence<Indices...>) {
+    (compareExchange(arr, SortingNetwork<N>::comparators[Indices].first, SortingNetwork<N>::comparators[Indices].second), ...);
+}
+
+// Sorts N elements with the unrolled network for N
+template <size_t N>
+constexpr void networkSort(int* arr) {
+    applyNetwork<N>(arr, std::make_index_sequence<comparatorCount(N)>());
+}
+
+template <size_t N>
+constexpr void networkSort(std::array<int, N>& arr) {
+    networkSort<N>(arr.data());
+}
+
+// Returns a sorted copy, usable to initialize constexpr tables
+template <size_t N>
+constexpr std::array<int, N> networkSorted(std::array<int, N> arr) {
+    networkSort<N>(arr.data());
+    return arr;
+}
+
+template <size_t N>
+constexpr bool isSorted(const std::array<int, N>& arr) {
+    for (size_t i_itr = 1; i_itr < N; i_itr++) {
+        if (arr[i_itr - 1] > arr[i_itr]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Lookup table sorted by the compiler
+constexpr std::array<int, 12> SORTED_TABLE = networkSorted(std::array<int, 12>{42, 7, 19, -3, 88, 0, 15, 23, 7, 61, -40, 5});
+static_assert(isSorted(SORTED_TABLE), "The network must sort the table at compile time");
+static_assert(comparatorCount(8) == 19, "Batcher's network for 8 elements has 19 comparators");
+
+void insertionSort(int* arr, size_t n) {
+    for (size_t i_itr = 1; i_itr < n; i_itr++) {
+        int key = arr[i_itr];
+        size_t j_itr = i_itr;
+
+        while (j_itr > 0 && arr[j_itr - 1] > key) {
+            arr[j_itr] = arr[j_itr - 1];
+            j_itr--;
+        }
+
+        arr[j_itr] = key;
+    }
+}
+
+// Returns false when insertion sort or the network does not match std::sort
+template <size_t N>
+bool benchmarkFixedSize() {
+    const size_t numArrays = 1000000;
+    std::mt19937 generator(42);
+    std::vector<std::array<int, N>> data(numArrays);
+    for (std::array<int, N>& arr : data) {
+        for (int& value : arr) {
+            value = static_cast<int>(generator());
+        }
+    }
+
+    std::vector<std::array<int, N>> reference = data;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (std::array<int, N>& arr : reference) {
+        std::sort(arr.begin(), arr.end());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto stdDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::vector<std::array<int, N>> copies = data;
+    start = std::chrono::high_resolution_clock::now();
+    for (std::array<int, N>& arr : copies) {
+        insertionSort(arr.data(), N);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto insertionDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    bool matches = copies == reference;
+
+    copies = data;
+    start = std::chrono::high_resolution_clock::now();
+    for (std::array<int, N>& arr : copies) {
+        networkSort(arr);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    auto networkDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    matches = matches && copies == reference;
+
+    std::cout << numArrays << " arrays of " << N << " (" << comparatorCount(N) << " comparators): "
+              << "std::sort " << stdDuration.count() << " ns, "
+              << "insertion sort " << insertionDuration.count() << " ns, "
+              << "network " << networkDuration.count() << " ns"
+              << (matches ? "" : " [MISMATCH]") << std::endl;
+    return matches;
+}
+
+void printArray(const int* arr, size_t size) {
+    for (size_t i_itr = 0; i_itr < size; i_itr++) {
+        std::cout << arr[i_itr] << " ";
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    // The benchmarks take seconds, so they only run with --benchmark
+    bool benchmark = argc == 2 && std::string(argv[1]) == "--benchmark";
+    if (argc > 1 && !benchmark) {
+        std::cerr << "Usage: " << argv[0] << " [--benchmark]" << std::endl;
+        return 1;
+    }
+
+    const char* filename = "../input_sort.txt";
+    std::ifstream inputFile(filename);
+
+    if (!inputFile) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+        return 1;
+    }
+
+    // The network size is fixed at compile time, so larger inputs are rejected instead of sorting only a part of them
+    const size_t capacity = 16;
+    size_t n;
+    if (!(inputFile >> n) || n > capacity) {
+        std::cerr << "The sorting network sorts at most " << capacity << " elements, " << filename
+                  << " must start with a count of 0 to " << capacity << std::endl;
+        return 1;
+    }
+
+    // Unused slots are padded with INT_MAX and stay at the end
+    std::array<int, capacity> arr;
+    arr.fill(INT_MAX);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        if (!(inputFile >> arr[i_itr])) {
+            std::cerr << "Expected " << n << " values in file: " << filename << std::endl;
+            return 1;
+        }
+    }
+
+    inputFile.close();
+
+    std::cout << "Unsorted array: ";
+    printArray(arr.data(), n);
+
+    // Measure the execution time
+    auto start = std::chrono::high_resolution_clock::now();
+    networkSort(arr);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << "Sorted array: ";
+    printArray(arr.data(), n);
+    std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
+
+    std::cout << "Lookup table sorted at compile time: ";
+    printArray(SORTED_TABLE.data(), SORTED_TABLE.size());
+
+    // Compare the networks with insertion sort and std::sort, a mismatch fails the run
+    if (benchmark) {
+        bool allMatch = benchmarkFixedSize<4>();
+        allMatch = benchmarkFixedSize<8>() && allMatch;
+        allMatch = benchmarkFixedSize<16>() && allMatch;
+        allMatch = benchmarkFixedSize<32>() && allMatch;
+        if (!allMatch) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,478 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+
+/*
+
+String sorting works on characters instead of whole keys. Comparison sorts on std::string look at the common prefix of two strings again
+on every comparison and move 32-byte string objects around, which makes them slow for long keys with shared prefixes (log keys, URLs).
+The algorithms below sort 8-byte handles into a contiguous string arena and only inspect each distinguishing character a small number of times.
+
+String Arena:
+   - All characters are stored back to back in one buffer, each string terminated by '\0', so the character at any depth past the end reads as 0.
+   - An offset array records where each string starts. The sort functions work on an array of pointers (handles) into the arena.
+   - Strings may not contain '\0' themselves.
+
+1. Multikey Quick Sort (three-way radix quick sort):
+   - Partitions the strings into <, = and > groups on the character at the current depth. Only the = group moves on to the next character.
+   - Time complexity: O(n log n + D) expected, where D is the total length of the distinguishing prefixes.
+   - Space complexity: O(log n) expected for the recursion.
+
+2. MSD Radix Sort with character caching:
+   - Distributes the strings into 256 buckets on the character at the current depth and recurses into every non-empty bucket.
+   - The characters at the current depth are read once into a contiguous cache, so the counting and distribution loops do not
+     dereference every string twice (one cache miss per string per level instead of two).
+   - Small buckets are handed to multikey quick sort, where the 256 counters would cost more than the data.
+   - When all strings have the same character at the current depth (long shared prefixes, duplicated keys) the depth advances in a loop
+     instead of a new recursion level. After MSD_RADIX_MAX_LEVELS levels the buckets go to multikey quick sort, and the counters of
+     every level live in one heap table, so long keys cannot exhaust the stack.
+   - Time complexity: O(D + n * alphabet) in the worst case, O(D) when buckets shrink quickly.
+   - Space complexity: O(n) for the handle buffer and the character cache.
+
+3. LCP Merge Sort:
+   - A merge sort that also produces the longest common prefix (LCP) of every string with its predecessor.
+   - While merging, the LCP of each run head with the last output string decides most comparisons without touching the characters,
+     and when characters must be compared the comparison starts at the known common prefix.
+   - Time complexity: O(n log n + D).
+   - Space complexity: O(n) for the merge buffers and the LCP arrays.
+
+*/
+
+using StringHandle = const unsigned char*;
+
+// Contiguous storage for a set of strings, addressed through offsets
+class StringArena {
+public:
+    void add(const std::string& str) {
+        offsets.push_back(chars.size());
+        chars.insert(chars.end(), str.begin(), str.end());
+        chars.push_back('\0');
+    }
+
+    size_t size() const {
+        return offsets.size();
+    }
+
+    // Handles are only valid until the next call to add()
+    std::vector<StringHandle> handles() const {
+        std::vector<StringHandle> result(offsets.size());
+        for (size_t i_itr = 0; i_itr < offsets.size(); i_itr++) {
+            result[i_itr] = chars.data() + offsets[i_itr];
+        }
+        return result;
+    }
+
+private:
+    std::vector<unsigned char> chars;
+    std::vector<size_t> offsets;
+};
+
+const size_t INSERTION_SORT_THRESHOLD = 16;
+const size_t MSD_RADIX_THRESHOLD = 64;
+const size_t MSD_RADIX_MAX_LEVELS = 32;
+
+// Compare two strings knowing that their first depth characters are equal
+int compareFrom(StringHandle a, StringHandle b, size_t depth) {
+    const unsigned char* pa = a + depth;
+    const unsigned char* pb = b + depth;
+    while (*pa != 0 && *pa == *pb) {
+        pa++;
+        pb++;
+    }
+    return static_cast<int>(*pa) - static_cast<int>(*pb);
+}
+
+// Insertion sort for small groups of strings sharing a prefix of length depth
+void insertionSort(StringHandle* strs, size_t n, size_t depth) {
+    for (size_t i_itr = 1; i_itr < n; i_itr++) {
+        StringHandle key = strs[i_itr];
+        size_t j_itr = i_itr;
+
+        while (j_itr > 0 && compareFrom(strs[j_itr - 1], key, depth) > 0) {
+            strs[j_itr] = strs[j_itr - 1];
+            j_itr--;
+        }
+
+        strs[j_itr] = key;
+    }
+}
+
+unsigned char medianOfThree(unsigned char a, unsigned char b, unsigned char c) {
+    if (a < b) {
+        return b < c ? b : (a < c ? c : a);
+    }
+    return a < c ? a : (b < c ? c : b);
+}
+
+void multikeyQuickSort(StringHandle* strs, size_t n, size_t depth) {
+    while (n > INSERTION_SORT_THRESHOLD) {
+        unsigned char pivot = medianOfThree(strs[0][depth], strs[n / 2][depth], strs[n - 1][depth]);
+
+        // Three-way partition on the character at the current depth:
+        // [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot
+        size_t lt = 0;
+        size_t gt = n;
+        size_t i_itr = 0;
+        while (i_itr < gt) {
+            unsigned char ch = strs[i_itr][depth];
+            if (ch < pivot) {
+                std::swap(strs[lt++], strs[i_itr++]);
+            } else if (ch > pivot) {
+                std::swap(strs[i_itr], strs[--gt]);
+            } else {
+                i_itr++;
+            }
+        }
+
+        multikeyQuickSort(strs, lt, depth);
+        multikeyQuickSort(strs + gt, n - gt, depth);
+
+        // All strings in the equal group ended, nothing left to sort
+        if (pivot == 0) {
+            return;
+        }
+
+        // Continue with the equal group on the next character
+        strs += lt;
+        n = gt - lt;
+        depth++;
+    }
+
+    insertionSort(strs, n, depth);
+}
+
+void multikeyQuickSort(std::vector<StringHandle>& strs) {
+    multikeyQuickSort(strs.data(), strs.size(), 0);
+}
+
+// strs, buffer and cache all cover the same n positions. tables holds the 2 * 256 counters of each of the levelsLeft remaining levels.
+void msdRadixSort(StringHandle* strs, size_t n, size_t depth, StringHandle* buffer, unsigned char* cache,
+                  size_t* tables, size_t levelsLeft) {
+    if (n < MSD_RADIX_THRESHOLD || levelsLeft == 0) {
+        multikeyQuickSort(strs, n, depth);
+        return;
+    }
+
+    size_t* count = tables;
+    size_t* position = tables + 256;
+
+    while (true) {
+        // Read the character at the current depth of every string once
+        std::fill(count, count + 256, 0);
+        for (size_t i_itr = 0; i_itr < n; i_itr++) {
+            cache[i_itr] = strs[i_itr][depth];
+            count[cache[i_itr]]++;
+        }
+
+        if (count[cache[0]] != n) {
+            break;
+        }
+
+        // Every string has the same character here: all ended and are equal, or move on to the next character on the same level
+        if (cache[0] == 0) {
+            return;
+        }
+        depth++;
+    }
+
+    // Turn the counts into bucket starting positions
+    size_t offset = 0;
+    for (int bucket = 0; bucket < 256; bucket++) {
+        position[bucket] = offset;
+        offset += count[bucket];
+    }
+
+    // Distribute the handles into the buffer and copy them back, afterwards position[bucket] is the end of the bucket
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        buffer[position[cache[i_itr]]++] = strs[i_itr];
+    }
+    std::memcpy(strs, buffer, n * sizeof(StringHandle));
+
+    // Bucket 0 holds the strings that ended, they are all equal
+    for (int bucket = 1; bucket < 256; bucket++) {
+        if (count[bucket] > 1) {
+            size_t start = position[bucket] - count[bucket];
+            msdRadixSort(strs + start, count[bucket], depth + 1, buffer + start, cache + start, tables + 2 * 256, levelsLeft - 1);
+        }
+    }
+}
+
+void msdRadixSort(std::vector<StringHandle>& strs) {
+    std::vector<StringHandle> buffer(strs.size());
+    std::vector<unsigned char> cache(strs.size());
+    std::vector<size_t> tables(2 * 256 * MSD_RADIX_MAX_LEVELS);
+    msdRadixSort(strs.data(), strs.size(), 0, buffer.data(), cache.data(), tables.data(), MSD_RADIX_MAX_LEVELS);
+}
+
+// Length of the common prefix of two strings that agree on their first depth characters
+size_t commonPrefix(StringHandle a, StringHandle b, size_t depth) {
+    while (a[depth] != 0 && a[depth] == b[depth]) {
+        depth++;
+    }
+    return depth;
+}
+
+// Merge two sorted runs with their LCP arrays into output.
+// lcp[i] is the common prefix of run[i] and run[i - 1], lcp[0] is ignored.
+void lcpMerge(const StringHandle* left, const size_t* leftLcp, size_t n1,
+              const StringHandle* right, const size_t* rightLcp, size_t n2,
+              StringHandle* output, size_t* outputLcp) {
+    size_t i = 0; // Index into the left run
+    size_t j = 0; // Index into the right run
+    size_t k = 0; // Index into the output
+
+    // Common prefix of each run head with the last string written to the output
+    size_t leftHeadLcp = 0;
+    size_t rightHeadLcp = 0;
+
+    while (i < n1 && j < n2) {
+        if (leftHeadLcp > rightHeadLcp) {
+            // The left head shares more with the last output, so it is the smaller one
+            outputLcp[k] = leftHeadLcp;
+            output[k++] = left[i++];
+            leftHeadLcp = i < n1 ? leftLcp[i] : 0;
+        } else if (leftHeadLcp < rightHeadLcp) {
+            outputLcp[k] = rightHeadLcp;
+            output[k++] = right[j++];
+            rightHeadLcp = j < n2 ? rightLcp[j] : 0;
+        } else {
+            // Equal prefixes, compare the characters that follow them
+            size_t h = commonPrefix(left[i], right[j], leftHeadLcp);
+            if (left[i][h] <= right[j][h]) {
+                outputLcp[k] = leftHeadLcp;
+                output[k++] = left[i++];
+                leftHeadLcp = i < n1 ? leftLcp[i] : 0;
+                rightHeadLcp = h;
+            } else {
+                outputLcp[k] = rightHeadLcp;
+                output[k++] = right[j++];
+                rightHeadLcp = j < n2 ? rightLcp[j] : 0;
+                leftHeadLcp = h;
+            }
+        }
+    }
+
+    // Copy the remaining strings, the first one carries the LCP with the last output
+    if (i < n1) {
+        outputLcp[k] = leftHeadLcp;
+        output[k++] = left[i++];
+        while (i < n1) {
+            outputLcp[k] = leftLcp[i];
+            output[k++] = left[i++];
+        }
+    }
+    if (j < n2) {
+        outputLcp[k] = rightHeadLcp;
+        output[k++] = right[j++];
+        while (j < n2) {
+            outputLcp[k] = rightLcp[j];
+            output[k++] = right[j++];
+        }
+    }
+}
+
+void lcpMergeSort(StringHandle* strs, size_t* lcp, size_t n, StringHandle* buffer, size_t* lcpBuffer) {
+    if (n <= INSERTION_SORT_THRESHOLD) {
+        insertionSort(strs, n, 0);
+        lcp[0] = 0;
+        for (size_t i_itr = 1; i_itr < n; i_itr++) {
+            lcp[i_itr] = commonPrefix(strs[i_itr - 1], strs[i_itr], 0);
+        }
+        return;
+    }
+
+    size_t middle = n / 2;
+
+    // Sort first and second halves
+    lcpMergeSort(strs, lcp, middle, buffer, lcpBuffer);
+    lcpMergeSort(strs + middle, lcp + middle, n - middle, buffer + middle, lcpBuffer + middle);
+
+    // Merge the sorted halves through the buffer
+    lcpMerge(strs, lcp, middle, strs + middle, lcp + middle, n - middle, buffer, lcpBuffer);
+    std::memcpy(strs, buffer, n * sizeof(StringHandle));
+    std::memcpy(lcp, lcpBuffer, n * sizeof(size_t));
+}
+
+// Sorts strs and returns the LCP of every string with its predecessor
+std::vector<size_t> lcpMergeSort(std::vector<StringHandle>& strs) {
+    std::vector<size_t> lcp(strs.size());
+    if (strs.empty()) {
+        return lcp;
+    }
+
+    std::vector<StringHandle> buffer(strs.size());
+    std::vector<size_t> lcpBuffer(strs.size());
+    lcpMergeSort(strs.data(), lcp.data(), strs.size(), buffer.data(), lcpBuffer.data());
+    return lcp;
+}
+
+void printArray(const std::vector<StringHandle>& strs) {
+    for (StringHandle str : strs) {
+        std::cout << reinterpret_cast<const char*>(str) << " ";
+    }
+    std::cout << std::endl;
+}
+
+bool matchesReference(const std::vector<StringHandle>& strs, const std::vector<std::string>& reference) {
+    for (size_t i_itr = 0; i_itr < strs.size(); i_itr++) {
+        if (reference[i_itr] != reinterpret_cast<const char*>(strs[i_itr])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Synthetic log keys and URLs with long shared prefixes
+std::vector<std::string> generateKeys(size_t n) {
+    std::mt19937_64 generator(42);
+    const char* hosts[] = {"api.example.com", "cdn.example.com", "www.example.org", "static.example.net"};
+    const char* services[] = {"auth", "billing", "search", "storage", "gateway"};
+
+    std::vector<std::string> keys(n);
+    for (size_t i_itr = 0; i_itr < n; i_itr++) {
+        uint64_t r = generator();
+        if (r & 1) {
+            keys[i_itr] = std::string("https://") + hosts[(r >> 1) % 4] + "/v1/users/" + std::to_string((r >> 8) % 100000) +
+                          "/items/" + std::to_string((r >> 24) % 1000);
+        } else {
+            keys[i_itr] = std::string("service=") + services[(r >> 1) % 5] + " level=INFO ts=2024-01-" +
+                          std::to_string(10 + (r >> 8) % 20) + "T" + std::to_string((r >> 16) % 1000000);
+        }
+    }
+    return keys;
+}
+
+// Returns false when the result does not match the reference
+template <typename SortFunction>
+bool benchmarkSort(const char* name, const StringArena& arena, const std::vector<std::string>& reference, SortFunction sortFunction) {
+    std::vector<StringHandle> strs = arena.handles();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    sortFunction(strs);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    bool matches = matchesReference(strs, reference);
+    std::cout << name << ": " << duration.count() << " nanoseconds" << (matches ? "" : " [MISMATCH]") << std::endl;
+    return matches;
+}
+
+// Duplicated keys thousands of characters long, and keys that split off one at a time over hundreds of characters
+bool checkLongKeys() {
+    std::vector<std::string> keys;
+    std::string url = "https://www.example.com/search?q=" + std::string(2500, 'x');
+    for (int i_itr = 0; i_itr < 100; i_itr++) {
+        keys.push_back(url);
+    }
+    for (int i_itr = 0; i_itr < 300; i_itr++) {
+        keys.push_back(std::string(i_itr, 'a') + "b" + std::string(100, 'c'));
+    }
+
+    StringArena arena;
+    for (const std::string& key : keys) {
+        arena.add(key);
+    }
+    std::vector<std::string> reference = keys;
+    std::sort(reference.begin(), reference.end());
+
+    std::vector<StringHandle> multikey = arena.handles();
+    multikeyQuickSort(multikey);
+    std::vector<StringHandle> msd = arena.handles();
+    msdRadixSort(msd);
+    std::vector<StringHandle> lcp = arena.handles();
+    lcpMergeSort(lcp);
+
+    bool matches = matchesReference(multikey, reference) && matchesReference(msd, reference) && matchesReference(lcp, reference);
+    if (!matches) {
+        std::cerr << "Long key check failed" << std::endl;
+    }
+    return matches;
+}
+
+// Returns false when a string sort does not match std::sort
+bool runBenchmarks() {
+    const size_t n = 1 << 20;
+    std::vector<std::string> keys = generateKeys(n);
+
+    StringArena arena;
+    for (const std::string& key : keys) {
+        arena.add(key);
+    }
+
+    std::vector<std::string> reference = keys;
+    auto start = std::chrono::high_resolution_clock::now();
+    std::sort(reference.begin(), reference.end());
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << "Sorting " << n << " keys" << std::endl;
+    std::cout << "std::sort on std::string: " << duration.count() << " nanoseconds" << std::endl;
+
+    bool allMatch = benchmarkSort("Multikey quick sort", arena, reference, [](std::vector<StringHandle>& strs) { multikeyQuickSort(strs); });
+    allMatch = benchmarkSort("MSD radix sort", arena, reference, [](std::vector<StringHandle>& strs) { msdRadixSort(strs); }) && allMatch;
+    allMatch = benchmarkSort("LCP merge sort", arena, reference, [](std::vector<StringHandle>& strs) { lcpMergeSort(strs); }) && allMatch;
+    return allMatch;
+}
+
+int main(int argc, char* argv[]) {
+    // The benchmarks take seconds, so they only run with --benchmark
+    bool benchmark = argc == 2 && std::string(argv[1]) == "--benchmark";
+    if (argc > 1 && !benchmark) {
+        std::cerr << "Usage: " << argv[0] << " [--benchmark]" << std::endl;
+        return 1;
+    }
+
+    const char* filename = "../input_sort.txt";
+    std::ifstream inputFile(filename);
+
+    if (!inputFile) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+        return 1;
+    }
+
+    int n;
+    inputFile >> n;
+
+    // The values are sorted as strings, so "12" comes before "9"
+    StringArena arena;
+    std::string str;
+    while(inputFile >> str){
+        arena.add(str);
+    }
+
+    inputFile.close();
+
+    std::vector<StringHandle> strs = arena.handles();
+
+    std::cout << "Unsorted array: ";
+    printArray(strs);
+
+    // Measure the execution time
+    auto start = std::chrono::high_resolution_clock::now();
+    msdRadixSort(strs);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << "Sorted array: ";
+    printArray(strs);
+    std::cout << "Time taken: " << duration.count() << " nanoseconds" << std::endl;
+
+    if (!checkLongKeys()) {
+        return 1;
+    }
+
+    // Compare the string sorts with std::sort on larger inputs, a mismatch fails the run
+    if (benchmark && !runBenchmarks()) {
+        return 1;
+    }
+
+    return 0;
+}